@@ -0,0 +1,273 @@
+#include "absorption.h"
+#include "matrix.h"
+#include "solver.h"
+#include "utils.h"
+#include <math.h>
+#include <string.h>
+
+// ============ Résolution par blocs ============
+
+// Coefficient d'une ligne du bloc creux avant tri
+typedef struct {
+    int column;
+    double value;
+} t_column_entry;
+
+static int compareColumnEntries(const void *a, const void *b) {
+    int ca = ((const t_column_entry *)a)->column;
+    int cb = ((const t_column_entry *)b)->column;
+    return (ca > cb) - (ca < cb);
+}
+
+// Bloc diagonal I - Q_cc de la classe c au format CSR (colonnes triées, arêtes
+// multiples fusionnées, coefficient diagonal toujours présent)
+static t_csr_matrix transientBlockCSR(t_adjacency_list adj_list, t_class *classe, int c,
+                                      const int *vertex_to_class, const int *vertex_to_local) {
+    int m = classe->nb_vertices;
+    int nnz = 0;
+    for (int i = 0; i < m; i++) {
+        nnz++;
+        for (t_cell *cell = adj_list.lists[classe->vertices[i] - 1].head; cell != NULL; cell = cell->next) {
+            if (vertex_to_class[cell->destination - 1] == c) nnz++;
+        }
+    }
+
+    t_csr_matrix a = createCSRMatrix(m, m, nnz);
+    t_column_entry *row = (t_column_entry *)malloc((nnz > 0 ? nnz : 1) * sizeof(t_column_entry));
+    if (row == NULL) {
+        perror("Failed to allocate memory for absorption block");
+        exit(EXIT_FAILURE);
+    }
+
+    int k = 0;
+    for (int i = 0; i < m; i++) {
+        int length = 0;
+        row[length].column = i;
+        row[length++].value = 1.0;
+        for (t_cell *cell = adj_list.lists[classe->vertices[i] - 1].head; cell != NULL; cell = cell->next) {
+            int dest = cell->destination - 1;
+            if (vertex_to_class[dest] != c) continue;
+            row[length].column = vertex_to_local[dest];
+            row[length++].value = -(double)cell->probability;
+        }
+        qsort(row, length, sizeof(t_column_entry), compareColumnEntries);
+
+        // Somme en double avant l'arrondi en float, pour garder 1 - p_ii exact
+        for (int j = 0; j < length; j++) {
+            double value = row[j].value;
+            while (j + 1 < length && row[j + 1].column == row[j].column) {
+                value += row[++j].value;
+            }
+            a.col_idx[k] = row[j].column;
+            a.values[k++] = (float)value;
+        }
+        a.row_ptr[i + 1] = k;
+    }
+    a.nnz = k;
+
+    free(row);
+    return a;
+}
+
+// Tarjan produit les classes dans l'ordre topologique inverse : une arête qui
+// quitte la classe c mène toujours à une classe d'indice inférieur. I - Q est
+// donc triangulaire par blocs dans cet ordre, et chaque classe transitoire se
+// résout une fois les classes qu'elle atteint résolues. Les nb_persistent + 1
+// seconds membres (une colonne par classe persistante, plus le temps) partagent
+// la factorisation du bloc diagonal : LU dense jusqu'à ABSORPTION_DENSE_MAX
+// états (m^2 mémoire, O(m^3) calcul), ILU(0) + BiCGStab/GMRES au-delà, dont le
+// coût suit le nombre d'arêtes internes de la classe.
+t_absorption_result computeAbsorption(t_adjacency_list adj_list, t_partition partition) {
+    int nb_vertices = adj_list.nb_vertices;
+    int nb_classes = partition.nb_classes;
+    int *vertex_to_class = createVertexToClassMap(partition, nb_vertices);
+    int *vertex_to_local = createVertexToLocalIndexMap(partition, nb_vertices);
+
+    t_absorption_result result;
+    memset(&result, 0, sizeof(result));
+
+    // Colonne de chaque classe persistante, -1 pour les classes transitoires
+    int *class_column = (int *)malloc((nb_classes > 0 ? nb_classes : 1) * sizeof(int));
+    result.persistent_classes = (int *)malloc((nb_classes > 0 ? nb_classes : 1) * sizeof(int));
+    if (class_column == NULL || result.persistent_classes == NULL) {
+        perror("Failed to allocate memory for absorption");
+        exit(EXIT_FAILURE);
+    }
+    for (int c = 0; c < nb_classes; c++) {
+        if (isPersistentClass(adj_list, partition, c, vertex_to_class)) {
+            class_column[c] = result.nb_persistent;
+            result.persistent_classes[result.nb_persistent++] = c;
+        } else {
+            class_column[c] = -1;
+            result.nb_transient += partition.classes[c].nb_vertices;
+        }
+    }
+
+    int nb_rhs = result.nb_persistent + 1;
+    int time_column = result.nb_persistent;
+
+    // Solution X de chaque sommet transitoire (nb_rhs valeurs par sommet)
+    int *vertex_to_row = (int *)malloc((nb_vertices > 0 ? nb_vertices : 1) * sizeof(int));
+    double *solution = (double *)calloc((size_t)(result.nb_transient > 0 ? result.nb_transient : 1) * nb_rhs,
+                                        sizeof(double));
+    result.transient_states = (int *)malloc((result.nb_transient > 0 ? result.nb_transient : 1) * sizeof(int));
+    if (vertex_to_row == NULL || solution == NULL || result.transient_states == NULL) {
+        perror("Failed to allocate memory for absorption");
+        exit(EXIT_FAILURE);
+    }
+
+    int next_row = 0;
+    for (int c = 0; c < nb_classes; c++) {
+        if (class_column[c] >= 0) continue;
+
+        t_class *classe = &partition.classes[c];
+        int m = classe->nb_vertices;
+        int first_row = next_row;
+        for (int i = 0; i < m; i++) {
+            vertex_to_row[classe->vertices[i] - 1] = next_row;
+            result.transient_states[next_row++] = classe->vertices[i];
+        }
+
+        // Bloc diagonal I - Q_cc (dense pour les petites classes) et seconds
+        // membres R_c + Q_cd X_d + [0 ... 0 1]
+        int dense = (m <= ABSORPTION_DENSE_MAX);
+        double *a = NULL;
+        int *pivots = NULL;
+        double *b = &solution[(size_t)first_row * nb_rhs];
+        if (dense) {
+            a = (double *)calloc((size_t)m * m, sizeof(double));
+            pivots = (int *)malloc(m * sizeof(int));
+            if (a == NULL || pivots == NULL) {
+                perror("Failed to allocate memory for absorption block");
+                exit(EXIT_FAILURE);
+            }
+        }
+
+        for (int i = 0; i < m; i++) {
+            if (dense) a[(size_t)i * m + i] = 1.0;
+            double *b_i = &b[(size_t)i * nb_rhs];
+            b_i[time_column] = 1.0;
+
+            t_cell *current = adj_list.lists[classe->vertices[i] - 1].head;
+            while (current != NULL) {
+                int dest = current->destination - 1;
+                int dest_class = vertex_to_class[dest];
+                double p = current->probability;
+                if (dest_class == c) {
+                    if (dense) a[(size_t)i * m + vertex_to_local[dest]] -= p;
+                } else if (class_column[dest_class] >= 0) {
+                    b_i[class_column[dest_class]] += p;
+                } else {
+                    // Classe transitoire déjà résolue (indice inférieur)
+                    if (dest_class > c) {
+                        fprintf(stderr, "Error: classes are not in reverse topological order\n");
+                        exit(EXIT_FAILURE);
+                    }
+                    const double *x_dest = &solution[(size_t)vertex_to_row[dest] * nb_rhs];
+                    for (int r = 0; r < nb_rhs; r++) {
+                        b_i[r] += p * x_dest[r];
+                    }
+                }
+                current = current->next;
+            }
+        }
+
+        if (dense) {
+            if (luFactorize(a, m, pivots) != 0) {
+                fprintf(stderr, "Error: singular transient block for class C%d\n", c + 1);
+                exit(EXIT_FAILURE);
+            }
+            luSolveMultiple(a, pivots, m, b, nb_rhs);
+            free(a);
+            free(pivots);
+        } else {
+            t_csr_matrix block = transientBlockCSR(adj_list, classe, c, vertex_to_class, vertex_to_local);
+            double residual = solveSparseMultiple(block, b, nb_rhs, ABSORPTION_MAX_ITERATIONS,
+                                                  ABSORPTION_TOLERANCE);
+            if (residual > ABSORPTION_TOLERANCE) {
+                fprintf(stderr, "Warning: absorption solve for class C%d stopped at relative residual %.3e\n",
+                        c + 1, residual);
+            }
+            freeCSRMatrix(&block);
+        }
+    }
+
+    // Séparer probabilités et temps
+    result.probabilities = (double *)malloc((size_t)(result.nb_transient > 0 ? result.nb_transient : 1) *
+                                            (result.nb_persistent > 0 ? result.nb_persistent : 1) *
+                                            sizeof(double));
+    result.expected_steps = (double *)malloc((result.nb_transient > 0 ? result.nb_transient : 1) *
+                                             sizeof(double));
+    if (result.probabilities == NULL || result.expected_steps == NULL) {
+        perror("Failed to allocate memory for absorption");
+        exit(EXIT_FAILURE);
+    }
+    for (int row = 0; row < result.nb_transient; row++) {
+        memcpy(&result.probabilities[(size_t)row * result.nb_persistent],
+               &solution[(size_t)row * nb_rhs], result.nb_persistent * sizeof(double));
+        result.expected_steps[row] = solution[(size_t)row * nb_rhs + time_column];
+    }
+
+    free(solution);
+    free(vertex_to_row);
+    free(class_column);
+    free(vertex_to_class);
+    free(vertex_to_local);
+
+    return result;
+}
+
+// ============ Affichage ============
+
+void displayAbsorptionResult(t_absorption_result result) {
+    printf("\n=== Absorption dans les classes persistantes ===\n\n");
+
+    if (result.nb_transient == 0) {
+        printf("Aucun état transitoire\n");
+        printf("================================================\n\n");
+        return;
+    }
+
+    printf("État ");
+    for (int k = 0; k < result.nb_persistent; k++) {
+        char label[16];
+        snprintf(label, sizeof(label), "P(C%d)", result.persistent_classes[k] + 1);
+        printf("  %8s", label);
+    }
+    printf("   Pas moyens\n");
+
+    // Au-delà de MATRIX_DISPLAY_MAX états transitoires, seuls les premiers sont affichés
+    int nb_displayed = min(result.nb_transient, MATRIX_DISPLAY_MAX);
+    double worst_sum_error = 0.0;
+    for (int row = 0; row < result.nb_transient; row++) {
+        double sum = 0.0;
+        for (int k = 0; k < result.nb_persistent; k++) {
+            sum += result.probabilities[(size_t)row * result.nb_persistent + k];
+        }
+        if (fabs(sum - 1.0) > worst_sum_error) worst_sum_error = fabs(sum - 1.0);
+
+        if (row >= nb_displayed) continue;
+        printf("%4d ", result.transient_states[row]);
+        for (int k = 0; k < result.nb_persistent; k++) {
+            double p = result.probabilities[(size_t)row * result.nb_persistent + k];
+            printf("  %8.4f", fabs(p) < 1e-12 ? 0.0 : p);  // Pas de "-0.0000"
+        }
+        printf("   %10.4f\n", result.expected_steps[row]);
+    }
+    if (nb_displayed < result.nb_transient) {
+        printf("... (%d autres états transitoires)\n", result.nb_transient - nb_displayed);
+    }
+    printf("Écart maximal de somme(P) à 1: %.3e\n", worst_sum_error);
+    printf("================================================\n\n");
+}
+
+void freeAbsorptionResult(t_absorption_result *result) {
+    free(result->transient_states);
+    free(result->persistent_classes);
+    free(result->probabilities);
+    free(result->expected_steps);
+    result->transient_states = NULL;
+    result->persistent_classes = NULL;
+    result->probabilities = NULL;
+    result->expected_steps = NULL;
+}
@@ -0,0 +1,34 @@
+#ifndef ABSORPTION_H
+#define ABSORPTION_H
+
+#include "graph.h"
+#include "tarjan.h"
+
+// Probabilités d'absorption et temps moyen avant absorption.
+// Avec Q le bloc des états transitoires et R les transitions vers les classes
+// persistantes, la matrice fondamentale N = (I - Q)^-1 donne :
+//   B = N R  (probabilité de finir dans chaque classe persistante)
+//   t = N 1  (nombre moyen de pas avant d'entrer dans une classe persistante)
+typedef struct {
+    int nb_transient;      // Nombre d'états transitoires
+    int nb_persistent;     // Nombre de classes persistantes
+    int *transient_states; // États transitoires (1-indexés)
+    int *persistent_classes; // Indices des classes persistantes dans la partition
+    double *probabilities; // nb_transient x nb_persistent (par lignes)
+    double *expected_steps; // Temps moyen avant absorption de chaque état transitoire
+} t_absorption_result;
+
+// Classes transitoires résolues par LU dense jusqu'à cette taille, au-delà par
+// une méthode de Krylov creuse (mémoire proportionnelle aux arêtes de la classe)
+#define ABSORPTION_DENSE_MAX 512
+
+// Résidu relatif visé et nombre maximal d'itérations de la résolution creuse
+#define ABSORPTION_TOLERANCE 1e-10
+#define ABSORPTION_MAX_ITERATIONS 1000
+
+// Résoudre (I - Q) X = [R 1] classe transitoire par classe transitoire
+t_absorption_result computeAbsorption(t_adjacency_list adj_list, t_partition partition);
+void displayAbsorptionResult(t_absorption_result result);
+void freeAbsorptionResult(t_absorption_result *result);
+
+#endif // ABSORPTION_H
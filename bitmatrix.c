@@ -0,0 +1,184 @@
+#include "bitmatrix.h"
+#include "utils.h"
+#include <string.h>
+
+// ============ Fonctions de base pour les matrices booléennes ============
+
+t_bit_matrix createBitMatrix(int n) {
+    t_bit_matrix matrix;
+    matrix.n = n;
+    matrix.words_per_row = (n + 63) / 64;
+
+    size_t nb_words = (size_t)n * matrix.words_per_row;
+    matrix.words = (uint64_t *)calloc(nb_words > 0 ? nb_words : 1, sizeof(uint64_t));
+    if (matrix.words == NULL) {
+        perror("Failed to allocate memory for bit matrix");
+        exit(EXIT_FAILURE);
+    }
+
+    return matrix;
+}
+
+void freeBitMatrix(t_bit_matrix *matrix) {
+    if (matrix->words != NULL) {
+        free(matrix->words);
+        matrix->words = NULL;
+    }
+}
+
+int getBit(t_bit_matrix matrix, int row, int col) {
+    uint64_t word = matrix.words[(size_t)row * matrix.words_per_row + col / 64];
+    return (int)((word >> (col % 64)) & 1u);
+}
+
+void setBit(t_bit_matrix matrix, int row, int col) {
+    matrix.words[(size_t)row * matrix.words_per_row + col / 64] |= (uint64_t)1 << (col % 64);
+}
+
+// ============ Création depuis un graphe ============
+
+t_bit_matrix adjacencyListToBitMatrix(t_adjacency_list adj_list) {
+    t_bit_matrix matrix = createBitMatrix(adj_list.nb_vertices);
+
+    for (int i = 0; i < adj_list.nb_vertices; i++) {
+        t_cell *current = adj_list.lists[i].head;
+        while (current != NULL) {
+            if (current->probability > 0.0f) {
+                setBit(matrix, i, current->destination - 1);
+            }
+            current = current->next;
+        }
+    }
+
+    return matrix;
+}
+
+// ============ Produit booléen ============
+
+static int lowestBitIndex(unsigned int value) {
+#if defined(__GNUC__)
+    return __builtin_ctz(value);
+#else
+    int index = 0;
+    while ((value & 1u) == 0) {
+        value >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+// Méthode des quatre Russes : les lignes de B sont regroupées par paquets de
+// BIT_MATRIX_GROUP, dont on précalcule les 2^8 combinaisons par OU. Chaque ligne
+// de A ne fait alors qu'un OU de ligne complète par octet non nul.
+// result ne doit pas être a ou b.
+void multiplyBitMatrices(t_bit_matrix a, t_bit_matrix b, t_bit_matrix result) {
+    if (a.n != b.n || a.n != result.n) {
+        fprintf(stderr, "Error: incompatible bit matrix dimensions for multiplication\n");
+        exit(EXIT_FAILURE);
+    }
+
+    int n = a.n;
+    int wpr = a.words_per_row;
+    memset(result.words, 0, (size_t)n * wpr * sizeof(uint64_t));
+
+    uint64_t *table = (uint64_t *)malloc(((size_t)1 << BIT_MATRIX_GROUP) * wpr * sizeof(uint64_t));
+    if (table == NULL) {
+        perror("Failed to allocate memory for Four Russians table");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int kb = 0; kb < n; kb += BIT_MATRIX_GROUP) {
+        int group = min(BIT_MATRIX_GROUP, n - kb);
+        unsigned int mask = (1u << group) - 1u;
+
+        // table[idx] = OU des lignes kb + bit de B pour chaque bit de idx
+        memset(table, 0, wpr * sizeof(uint64_t));
+        for (unsigned int idx = 1; idx <= mask; idx++) {
+            unsigned int low = idx & (~idx + 1u);
+            const uint64_t *prev = &table[(size_t)(idx ^ low) * wpr];
+            const uint64_t *row = &b.words[(size_t)(kb + lowestBitIndex(idx)) * wpr];
+            uint64_t *dest = &table[(size_t)idx * wpr];
+            for (int w = 0; w < wpr; w++) {
+                dest[w] = prev[w] | row[w];
+            }
+        }
+
+        // Les paquets de 8 colonnes ne chevauchent jamais deux mots
+        int word = kb / 64;
+        int shift = kb % 64;
+        for (int i = 0; i < n; i++) {
+            unsigned int idx = (unsigned int)(a.words[(size_t)i * wpr + word] >> shift) & mask;
+            if (idx == 0) continue;
+            const uint64_t *src = &table[(size_t)idx * wpr];
+            uint64_t *dest = &result.words[(size_t)i * wpr];
+            for (int w = 0; w < wpr; w++) {
+                dest[w] |= src[w];
+            }
+        }
+    }
+
+    free(table);
+}
+
+// Puissance par élévations au carré successives (O(log power) produits)
+t_bit_matrix bitMatrixPower(t_bit_matrix matrix, int power) {
+    if (power < 0) {
+        fprintf(stderr, "Error: power must be non-negative\n");
+        exit(EXIT_FAILURE);
+    }
+
+    int n = matrix.n;
+    size_t nb_bytes = (size_t)n * matrix.words_per_row * sizeof(uint64_t);
+
+    t_bit_matrix result = createBitMatrix(n);
+    for (int i = 0; i < n; i++) {
+        setBit(result, i, i);
+    }
+
+    t_bit_matrix base = createBitMatrix(n);
+    t_bit_matrix temp = createBitMatrix(n);
+    memcpy(base.words, matrix.words, nb_bytes);
+
+    while (power > 0) {
+        if (power & 1) {
+            multiplyBitMatrices(result, base, temp);
+            memcpy(result.words, temp.words, nb_bytes);
+        }
+        power >>= 1;
+        if (power > 0) {
+            multiplyBitMatrices(base, base, temp);
+            memcpy(base.words, temp.words, nb_bytes);
+        }
+    }
+
+    freeBitMatrix(&base);
+    freeBitMatrix(&temp);
+    return result;
+}
+
+// ============ Requêtes structurelles ============
+
+// Afficher les états accessibles en exactement k pas depuis chaque état
+void displayReachability(t_adjacency_list adj_list, int steps) {
+    printf("\n=== Accessibilité en %d pas (structure de M^%d) ===\n", steps, steps);
+
+    t_bit_matrix structure = adjacencyListToBitMatrix(adj_list);
+    t_bit_matrix reach = bitMatrixPower(structure, steps);
+
+    for (int i = 0; i < reach.n; i++) {
+        printf("Sommet %d -> {", i + 1);
+        int first = 1;
+        for (int j = 0; j < reach.n; j++) {
+            if (getBit(reach, i, j)) {
+                printf(first ? "%d" : ",%d", j + 1);
+                first = 0;
+            }
+        }
+        printf("}\n");
+    }
+    printf("=================================================\n\n");
+
+    freeBitMatrix(&structure);
+    freeBitMatrix(&reach);
+}
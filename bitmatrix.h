@@ -0,0 +1,34 @@
+#ifndef BITMATRIX_H
+#define BITMATRIX_H
+
+#include <stdint.h>
+#include "graph.h"
+
+// Nombre de lignes regroupées par table dans la méthode des quatre Russes
+#define BIT_MATRIX_GROUP 8
+
+// Structure pour une matrice booléenne compacte (64 colonnes par mot)
+// Seule la structure (coefficient nul ou non) est conservée
+typedef struct {
+    uint64_t *words;       // Lignes consécutives de words_per_row mots
+    int n;                 // Nombre de lignes et de colonnes
+    int words_per_row;     // Nombre de mots de 64 bits par ligne
+} t_bit_matrix;
+
+// Fonctions de base pour les matrices booléennes
+t_bit_matrix createBitMatrix(int n);
+void freeBitMatrix(t_bit_matrix *matrix);
+int getBit(t_bit_matrix matrix, int row, int col);
+void setBit(t_bit_matrix matrix, int row, int col);
+
+// Création depuis un graphe
+t_bit_matrix adjacencyListToBitMatrix(t_adjacency_list adj_list);
+
+// Produit booléen (OU de ET) et puissances
+void multiplyBitMatrices(t_bit_matrix a, t_bit_matrix b, t_bit_matrix result);
+t_bit_matrix bitMatrixPower(t_bit_matrix matrix, int power);
+
+// Requêtes structurelles
+void displayReachability(t_adjacency_list adj_list, int steps);
+
+#endif // BITMATRIX_H
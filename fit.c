@@ -0,0 +1,608 @@
+// Journaux de plusieurs Go : positions de fichier sur 64 bits
+#define _FILE_OFFSET_BITS 64
+
+#include "fit.h"
+#include "parallel.h"
+#include "trajectory.h"
+#include <string.h>
+#include <math.h>
+
+// Positionnement 64 bits : les journaux de trajectoires dépassent souvent 2 Go
+static void seekFile(FILE *file, long long offset, int whence) {
+#ifdef _WIN32
+    _fseeki64(file, offset, whence);
+#else
+    fseeko(file, (off_t)offset, whence);
+#endif
+}
+
+static long long tellFile(FILE *file) {
+#ifdef _WIN32
+    return _ftelli64(file);
+#else
+    return (long long)ftello(file);
+#endif
+}
+
+// ============ Table de comptage ============
+
+t_transition_table createTransitionTable(size_t capacity) {
+    t_transition_table table;
+    size_t size = 1;
+    while (size < capacity) size <<= 1;
+
+    table.capacity = size;
+    table.size = 0;
+    table.epochs = NULL;
+    table.keys = (uint64_t *)malloc(size * sizeof(uint64_t));
+    table.counts = (double *)calloc(size, sizeof(double));
+    if (table.keys == NULL || table.counts == NULL) {
+        perror("Failed to allocate memory for transition table");
+        exit(EXIT_FAILURE);
+    }
+    memset(table.keys, 0xFF, size * sizeof(uint64_t));
+
+    return table;
+}
+
+void freeTransitionTable(t_transition_table *table) {
+    free(table->keys);
+    free(table->counts);
+    free(table->epochs);
+    table->keys = NULL;
+    table->counts = NULL;
+    table->epochs = NULL;
+    table->size = 0;
+}
+
+static size_t hashTransition(uint64_t key, size_t capacity) {
+    key ^= key >> 33;
+    key *= 0xFF51AFD7ED558CCDULL;
+    key ^= key >> 33;
+    return (size_t)key & (capacity - 1);
+}
+
+static size_t findTransitionSlot(t_transition_table *table, uint64_t key) {
+    size_t slot = hashTransition(key, table->capacity);
+    while (table->keys[slot] != key && table->keys[slot] != TRANSITION_EMPTY) {
+        slot = (slot + 1) & (table->capacity - 1);
+    }
+    if (table->keys[slot] == TRANSITION_EMPTY) {
+        table->keys[slot] = key;
+        table->size++;
+    }
+    return slot;
+}
+
+static void insertTransitionKey(t_transition_table *table, uint64_t key, double weight) {
+    table->counts[findTransitionSlot(table, key)] += weight;
+}
+
+// Doubler la capacité quand la table est à moitié pleine
+static void growTransitionTable(t_transition_table *table) {
+    t_transition_table larger = createTransitionTable(table->capacity * 2);
+    if (table->epochs != NULL) {
+        enableTransitionEpochs(&larger);
+    }
+    for (size_t i = 0; i < table->capacity; i++) {
+        if (table->keys[i] != TRANSITION_EMPTY) {
+            size_t slot = findTransitionSlot(&larger, table->keys[i]);
+            larger.counts[slot] = table->counts[i];
+            if (larger.epochs != NULL) {
+                larger.epochs[slot] = table->epochs[i];
+            }
+        }
+    }
+    freeTransitionTable(table);
+    *table = larger;
+}
+
+void addTransition(t_transition_table *table, int from, int to, double weight) {
+    if (2 * (table->size + 1) > table->capacity) {
+        growTransitionTable(table);
+    }
+    insertTransitionKey(table, ((uint64_t)(uint32_t)from << 32) | (uint32_t)to, weight);
+}
+
+// Suppression par décalage arrière : les clés qui suivent le trou dans leur
+// séquence de sondage y sont ramenées, la table reste sans marque de suppression
+static void deleteTransitionSlot(t_transition_table *table, size_t slot) {
+    size_t mask = table->capacity - 1;
+    size_t hole = slot;
+    size_t next = (hole + 1) & mask;
+    while (table->keys[next] != TRANSITION_EMPTY) {
+        size_t home = hashTransition(table->keys[next], table->capacity);
+        // La clé peut occuper le trou s'il se trouve entre sa case d'origine et elle
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            table->keys[hole] = table->keys[next];
+            table->counts[hole] = table->counts[next];
+            if (table->epochs != NULL) {
+                table->epochs[hole] = table->epochs[next];
+            }
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    table->keys[hole] = TRANSITION_EMPTY;
+    table->counts[hole] = 0.0;
+    table->size--;
+}
+
+void removeTransition(t_transition_table *table, int from, int to, double weight) {
+    uint64_t key = ((uint64_t)(uint32_t)from << 32) | (uint32_t)to;
+    size_t slot = hashTransition(key, table->capacity);
+    while (table->keys[slot] != key) {
+        if (table->keys[slot] == TRANSITION_EMPTY) return;
+        slot = (slot + 1) & (table->capacity - 1);
+    }
+
+    table->counts[slot] -= weight;
+    if (table->counts[slot] <= 0.0) {
+        deleteTransitionSlot(table, slot);
+    }
+}
+
+// ============ Tables à oubli ============
+
+void enableTransitionEpochs(t_transition_table *table) {
+    table->epochs = (unsigned *)calloc(table->capacity, sizeof(unsigned));
+    if (table->epochs == NULL) {
+        perror("Failed to allocate memory for transition epochs");
+        exit(EXIT_FAILURE);
+    }
+}
+
+double transitionCountAtEpoch(t_transition_table table, size_t slot, unsigned epoch, double factor) {
+    unsigned age = epoch - table.epochs[slot];
+    if (age == 0) return table.counts[slot];
+    return table.counts[slot] * pow(factor, (double)age);
+}
+
+void addDecayedTransition(t_transition_table *table, int from, int to, double weight,
+                          unsigned epoch, double factor) {
+    if (2 * (table->size + 1) > table->capacity) {
+        growTransitionTable(table);
+    }
+    size_t slot = findTransitionSlot(table, ((uint64_t)(uint32_t)from << 32) | (uint32_t)to);
+    table->counts[slot] = transitionCountAtEpoch(*table, slot, epoch, factor) + weight;
+    table->epochs[slot] = epoch;
+}
+
+// Une case vidée est réexaminée : le décalage arrière peut y avoir ramené une clé
+size_t sweepDecayedTransitions(t_transition_table *table, size_t cursor, int nb_slots,
+                               unsigned epoch, double factor, double threshold) {
+    size_t mask = table->capacity - 1;
+    cursor &= mask;
+    for (int k = 0; k < nb_slots && table->size > 0; k++) {
+        if (table->keys[cursor] != TRANSITION_EMPTY) {
+            double count = transitionCountAtEpoch(*table, cursor, epoch, factor);
+            if (count < threshold) {
+                deleteTransitionSlot(table, cursor);
+                continue;
+            }
+            table->counts[cursor] = count;
+            table->epochs[cursor] = epoch;
+        }
+        cursor = (cursor + 1) & mask;
+    }
+    return cursor;
+}
+
+void mergeTransitionTables(t_transition_table *dest, t_transition_table src) {
+    for (size_t i = 0; i < src.capacity; i++) {
+        if (src.keys[i] != TRANSITION_EMPTY) {
+            if (2 * (dest->size + 1) > dest->capacity) {
+                growTransitionTable(dest);
+            }
+            insertTransitionKey(dest, src.keys[i], src.counts[i]);
+        }
+    }
+}
+
+// ============ Conversion en graphe ============
+
+static int compareKeys(const void *a, const void *b) {
+    uint64_t ka = *(const uint64_t *)a;
+    uint64_t kb = *(const uint64_t *)b;
+    return (ka > kb) - (ka < kb);
+}
+
+// Transitions triées par (départ, arrivée) et total de chaque ligne
+static uint64_t *sortedTransitions(t_transition_table table, int nb_vertices, double **row_totals) {
+    uint64_t *keys = (uint64_t *)malloc((table.size > 0 ? table.size : 1) * sizeof(uint64_t));
+    double *totals = (double *)calloc(nb_vertices > 0 ? nb_vertices : 1, sizeof(double));
+    if (keys == NULL || totals == NULL) {
+        perror("Failed to allocate memory for fitted graph");
+        exit(EXIT_FAILURE);
+    }
+
+    size_t k = 0;
+    for (size_t i = 0; i < table.capacity; i++) {
+        if (table.keys[i] != TRANSITION_EMPTY) {
+            keys[k++] = table.keys[i];
+            totals[table.keys[i] >> 32] += table.counts[i];
+        }
+    }
+    qsort(keys, table.size, sizeof(uint64_t), compareKeys);
+
+    *row_totals = totals;
+    return keys;
+}
+
+static double transitionCount(t_transition_table table, uint64_t key) {
+    size_t slot = hashTransition(key, table.capacity);
+    while (table.keys[slot] != key) {
+        if (table.keys[slot] == TRANSITION_EMPTY) return 0.0;
+        slot = (slot + 1) & (table.capacity - 1);
+    }
+    return table.counts[slot];
+}
+
+t_adjacency_list transitionTableToAdjacencyList(t_transition_table table, int nb_vertices) {
+    double *totals;
+    uint64_t *keys = sortedTransitions(table, nb_vertices, &totals);
+    t_adjacency_list adj_list = createAdjacencyList(nb_vertices);
+
+    for (size_t i = 0; i < table.size; i++) {
+        int from = (int)(keys[i] >> 32);
+        int to = (int)(keys[i] & 0xFFFFFFFFu);
+        double count = transitionCount(table, keys[i]);
+        if (totals[from] > 0.0 && count > 0.0) {
+            addEdge(&adj_list, from + 1, to + 1, (float)(count / totals[from]));
+        }
+    }
+
+    free(keys);
+    free(totals);
+    return adj_list;
+}
+
+// Écriture au format lu par readGraph (nombre de sommets puis "départ arrivée probabilité")
+void writeTransitionGraph(t_transition_table table, int nb_vertices, const char *filename) {
+    FILE *file = fopen(filename, "w");
+    if (file == NULL) {
+        perror("Could not open file for writing");
+        exit(EXIT_FAILURE);
+    }
+
+    double *totals;
+    uint64_t *keys = sortedTransitions(table, nb_vertices, &totals);
+
+    fprintf(file, "%d\n", nb_vertices);
+    for (size_t i = 0; i < table.size; i++) {
+        int from = (int)(keys[i] >> 32);
+        int to = (int)(keys[i] & 0xFFFFFFFFu);
+        double count = transitionCount(table, keys[i]);
+        if (totals[from] > 0.0 && count > 0.0) {
+            fprintf(file, "%d %d %.6f\n", from + 1, to + 1, count / totals[from]);
+        }
+    }
+
+    fclose(file);
+    free(keys);
+    free(totals);
+}
+
+// ============ Lecture parallèle des trajectoires ============
+
+// Contexte partagé par les tâches de lecture (une table par tâche)
+typedef struct {
+    const char *filename;
+    int binary;            // Fichier au format --trajectory
+    long long file_size;
+    int nb_tasks;
+    t_transition_table *tables;
+    int *max_state;        // Plus grand état (0-indexé) vu par chaque tâche
+    long long *transitions;
+    // Fichiers binaires : index des blocs et états aux bords de chaque bloc
+    t_trajectory_seek *seeks;
+    long long nb_seeks;
+    int *first_states;
+    int *last_states;
+    long long *counts;
+    int header_vertices;   // Nombre d'états déclaré dans l'en-tête
+} t_fit_context;
+
+// Fichier texte : la tâche traite les lignes qui commencent dans sa tranche d'octets
+static void fitTextTask(int task_index, void *context) {
+    t_fit_context *ctx = (t_fit_context *)context;
+    long long start = ctx->file_size * task_index / ctx->nb_tasks;
+    long long end = ctx->file_size * (task_index + 1) / ctx->nb_tasks;
+    if (start >= end) return;
+
+    FILE *file = fopen(ctx->filename, "rb");
+    if (file == NULL) {
+        perror("Could not open trajectory file");
+        exit(EXIT_FAILURE);
+    }
+
+    // Se placer au début de la première ligne complète de la tranche
+    long long position = start;
+    if (start > 0) {
+        seekFile(file, start - 1, SEEK_SET);
+        position = start - 1;
+        int c;
+        while ((c = fgetc(file)) != EOF) {
+            position++;
+            if (c == '\n') break;
+        }
+        if (c == EOF) {
+            fclose(file);
+            return;
+        }
+    }
+
+    t_transition_table *table = &ctx->tables[task_index];
+    char *buffer = (char *)malloc(FIT_READ_BUFFER);
+    if (buffer == NULL) {
+        perror("Failed to allocate memory for trajectory buffer");
+        exit(EXIT_FAILURE);
+    }
+
+    int previous = -1;     // État précédent sur la ligne (0-indexé), -1 en début de ligne
+    long long value = 0;
+    int in_number = 0;
+    int max_state = ctx->max_state[task_index];
+    long long transitions = 0;
+    int finished = (position >= end);
+
+    while (!finished) {
+        size_t nb_read = fread(buffer, 1, FIT_READ_BUFFER, file);
+        if (nb_read == 0) break;
+        for (size_t i = 0; i < nb_read; i++) {
+            char c = buffer[i];
+            if (c >= '0' && c <= '9') {
+                value = value * 10 + (c - '0');
+                in_number = 1;
+                continue;
+            }
+            if (in_number) {
+                int state = (int)value - 1;
+                if (state > max_state) max_state = state;
+                if (previous >= 0 && state >= 0) {
+                    addTransition(table, previous, state, 1.0);
+                    transitions++;
+                }
+                previous = state;
+                value = 0;
+                in_number = 0;
+            }
+            if (c == '\n') {
+                previous = -1;
+                // La ligne suivante commence hors de la tranche : elle appartient à la tâche suivante
+                if (position + (long long)i + 1 >= end) {
+                    finished = 1;
+                    break;
+                }
+            }
+        }
+        position += (long long)nb_read;
+    }
+
+    // Dernier nombre d'un fichier sans retour à la ligne final
+    if (!finished && in_number) {
+        int state = (int)value - 1;
+        if (state > max_state) max_state = state;
+        if (previous >= 0 && state >= 0) {
+            addTransition(table, previous, state, 1.0);
+            transitions++;
+        }
+    }
+
+    ctx->max_state[task_index] = max_state;
+    ctx->transitions[task_index] += transitions;
+    free(buffer);
+    fclose(file);
+}
+
+static uint64_t readFixed(const unsigned char *bytes, int nb_bytes) {
+    uint64_t value = 0;
+    for (int i = nb_bytes - 1; i >= 0; i--) {
+        value = (value << 8) | bytes[i];
+    }
+    return value;
+}
+
+static uint64_t readVarint(FILE *file) {
+    uint64_t value = 0;
+    int shift = 0;
+    int c;
+    while ((c = fgetc(file)) != EOF) {
+        value |= (uint64_t)(c & 0x7F) << shift;
+        if (c < 0x80) return value;
+        shift += 7;
+    }
+    fprintf(stderr, "Error: truncated trajectory file\n");
+    exit(EXIT_FAILURE);
+}
+
+// Fichier binaire : la tâche décode une tranche des blocs de l'index
+static void fitBinaryTask(int task_index, void *context) {
+    t_fit_context *ctx = (t_fit_context *)context;
+    long long first = ctx->nb_seeks * task_index / ctx->nb_tasks;
+    long long last = ctx->nb_seeks * (task_index + 1) / ctx->nb_tasks;
+    if (first >= last) return;
+
+    FILE *file = fopen(ctx->filename, "rb");
+    if (file == NULL) {
+        perror("Could not open trajectory file");
+        exit(EXIT_FAILURE);
+    }
+
+    t_transition_table *table = &ctx->tables[task_index];
+    int max_state = ctx->max_state[task_index];
+    long long transitions = 0;
+
+    for (long long b = first; b < last; b++) {
+        seekFile(file, (long long)ctx->seeks[b].offset, SEEK_SET);
+        readVarint(file);  // Marcheur et premier pas : déjà dans l'index
+        readVarint(file);
+        long long count = (long long)readVarint(file);
+        ctx->counts[b] = count;
+        if (count == 0) continue;
+
+        int state = (int)readVarint(file);
+        ctx->first_states[b] = state;
+        if (state > max_state) max_state = state;
+        for (long long i = 1; i < count; i++) {
+            uint64_t zz = readVarint(file);
+            int next = state + (int)((int64_t)(zz >> 1) ^ -(int64_t)(zz & 1));
+            addTransition(table, state, next, 1.0);
+            if (next > max_state) max_state = next;
+            state = next;
+        }
+        transitions += count - 1;
+        ctx->last_states[b] = state;
+    }
+
+    ctx->max_state[task_index] = max_state;
+    ctx->transitions[task_index] += transitions;
+    fclose(file);
+}
+
+static int compareSeeks(const void *a, const void *b) {
+    const t_trajectory_seek *sa = (const t_trajectory_seek *)a;
+    const t_trajectory_seek *sb = (const t_trajectory_seek *)b;
+    if (sa->walker != sb->walker) return (sa->walker > sb->walker) - (sa->walker < sb->walker);
+    return (sa->first_step > sb->first_step) - (sa->first_step < sb->first_step);
+}
+
+// Lire l'index d'un fichier binaire ; retourne 0 si le fichier n'est pas au format --trajectory
+static int loadTrajectoryIndex(FILE *file, long long file_size, t_fit_context *ctx) {
+    unsigned char header[40];
+    if (file_size < 40 || fread(header, 1, 40, file) != 40 ||
+        memcmp(header, TRAJECTORY_MAGIC, 4) != 0) {
+        return 0;
+    }
+    ctx->header_vertices = (int)readFixed(header + 8, 4);
+
+    unsigned char footer[20];
+    seekFile(file, file_size - 20, SEEK_SET);
+    if (fread(footer, 1, 20, file) != 20 || memcmp(footer + 16, TRAJECTORY_INDEX_MAGIC, 4) != 0) {
+        fprintf(stderr, "Error: trajectory file without index (incomplete write?)\n");
+        exit(EXIT_FAILURE);
+    }
+    uint64_t index_offset = readFixed(footer, 8);
+    ctx->nb_seeks = (long long)readFixed(footer + 8, 8);
+
+    ctx->seeks = (t_trajectory_seek *)malloc((ctx->nb_seeks > 0 ? ctx->nb_seeks : 1) *
+                                             sizeof(t_trajectory_seek));
+    if (ctx->seeks == NULL) {
+        perror("Failed to allocate memory for trajectory index");
+        exit(EXIT_FAILURE);
+    }
+    seekFile(file, (long long)index_offset, SEEK_SET);
+    for (long long i = 0; i < ctx->nb_seeks; i++) {
+        unsigned char entry[24];
+        if (fread(entry, 1, 24, file) != 24) {
+            fprintf(stderr, "Error: truncated trajectory index\n");
+            exit(EXIT_FAILURE);
+        }
+        ctx->seeks[i].walker = readFixed(entry, 8);
+        ctx->seeks[i].first_step = readFixed(entry + 8, 8);
+        ctx->seeks[i].offset = readFixed(entry + 16, 8);
+    }
+
+    // Blocs rangés par marcheur puis par pas : les raccords entre blocs consécutifs
+    // d'un même marcheur se retrouvent côte à côte
+    qsort(ctx->seeks, ctx->nb_seeks, sizeof(t_trajectory_seek), compareSeeks);
+    return 1;
+}
+
+t_fit_result fitTransitions(const char **filenames, int nb_files) {
+    t_fit_result result;
+    int nb_tasks = getThreadCount();
+
+    t_fit_context context;
+    memset(&context, 0, sizeof(context));
+    context.nb_tasks = nb_tasks;
+    context.tables = (t_transition_table *)malloc(nb_tasks * sizeof(t_transition_table));
+    context.max_state = (int *)malloc(nb_tasks * sizeof(int));
+    context.transitions = (long long *)calloc(nb_tasks, sizeof(long long));
+    if (context.tables == NULL || context.max_state == NULL || context.transitions == NULL) {
+        perror("Failed to allocate memory for transition counting");
+        exit(EXIT_FAILURE);
+    }
+    for (int t = 0; t < nb_tasks; t++) {
+        context.tables[t] = createTransitionTable(TRANSITION_TABLE_INITIAL);
+        context.max_state[t] = -1;
+    }
+
+    double start_time = getWallTime();
+
+    for (int f = 0; f < nb_files; f++) {
+        FILE *file = fopen(filenames[f], "rb");
+        if (file == NULL) {
+            perror("Could not open trajectory file");
+            exit(EXIT_FAILURE);
+        }
+        seekFile(file, 0, SEEK_END);
+        context.file_size = tellFile(file);
+        seekFile(file, 0, SEEK_SET);
+        context.filename = filenames[f];
+        context.binary = loadTrajectoryIndex(file, context.file_size, &context);
+        fclose(file);
+
+        if (!context.binary) {
+            printf("Lecture de %s (texte)...\n", filenames[f]);
+            parallelFor(nb_tasks, fitTextTask, &context);
+            continue;
+        }
+
+        printf("Lecture de %s (binaire, %lld blocs)...\n", filenames[f], context.nb_seeks);
+        if (context.header_vertices - 1 > context.max_state[0]) {
+            context.max_state[0] = context.header_vertices - 1;
+        }
+        long long nb = context.nb_seeks > 0 ? context.nb_seeks : 1;
+        context.first_states = (int *)malloc(nb * sizeof(int));
+        context.last_states = (int *)malloc(nb * sizeof(int));
+        context.counts = (long long *)calloc(nb, sizeof(long long));
+        if (context.first_states == NULL || context.last_states == NULL || context.counts == NULL) {
+            perror("Failed to allocate memory for trajectory blocks");
+            exit(EXIT_FAILURE);
+        }
+        parallelFor(nb_tasks, fitBinaryTask, &context);
+
+        // Transitions entre la fin d'un bloc et le début du bloc suivant du même marcheur
+        for (long long b = 1; b < context.nb_seeks; b++) {
+            t_trajectory_seek *prev = &context.seeks[b - 1];
+            if (prev->walker == context.seeks[b].walker && context.counts[b - 1] > 0 &&
+                context.counts[b] > 0 &&
+                prev->first_step + (uint64_t)context.counts[b - 1] == context.seeks[b].first_step) {
+                addTransition(&context.tables[0], context.last_states[b - 1],
+                              context.first_states[b], 1.0);
+                context.transitions[0]++;
+            }
+        }
+
+        free(context.seeks);
+        free(context.first_states);
+        free(context.last_states);
+        free(context.counts);
+        context.seeks = NULL;
+    }
+
+    // Fusion des tables des tâches
+    result.counts = context.tables[0];
+    result.nb_vertices = context.max_state[0] + 1;
+    result.transitions = context.transitions[0];
+    for (int t = 1; t < nb_tasks; t++) {
+        mergeTransitionTables(&result.counts, context.tables[t]);
+        freeTransitionTable(&context.tables[t]);
+        if (context.max_state[t] + 1 > result.nb_vertices) {
+            result.nb_vertices = context.max_state[t] + 1;
+        }
+        result.transitions += context.transitions[t];
+    }
+    result.seconds = getWallTime() - start_time;
+
+    free(context.tables);
+    free(context.max_state);
+    free(context.transitions);
+
+    return result;
+}
+
+void freeFitResult(t_fit_result *result) {
+    freeTransitionTable(&result->counts);
+}
@@ -0,0 +1,66 @@
+#ifndef FIT_H
+#define FIT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "graph.h"
+
+// Capacité initiale d'une table de comptage (puissance de 2)
+#define TRANSITION_TABLE_INITIAL 1024
+
+// Taille des lectures lors de l'analyse des fichiers texte
+#define FIT_READ_BUFFER (1 << 16)
+
+// Table de hachage (adressage ouvert) des comptages de transitions observées.
+// La clé code la paire (départ, arrivée) 0-indexée ; la mémoire est
+// proportionnelle au nombre de transitions distinctes.
+typedef struct {
+    uint64_t *keys;        // (départ << 32) | arrivée, TRANSITION_EMPTY si libre
+    double *counts;        // Comptage (éventuellement pondéré) de chaque transition
+    unsigned *epochs;      // Époque de chaque comptage (tables à oubli, NULL sinon)
+    size_t capacity;       // Nombre de cases (puissance de 2)
+    size_t size;           // Nombre de transitions distinctes
+} t_transition_table;
+
+#define TRANSITION_EMPTY UINT64_MAX
+
+// Fonctions pour les tables de comptage
+t_transition_table createTransitionTable(size_t capacity);
+void freeTransitionTable(t_transition_table *table);
+void addTransition(t_transition_table *table, int from, int to, double weight);
+// Retirer weight au comptage de la transition ; elle disparaît de la table
+// quand son comptage tombe à 0
+void removeTransition(t_transition_table *table, int from, int to, double weight);
+
+// Tables à oubli : chaque comptage est exprimé à l'échelle de l'époque de sa
+// dernière mise à jour, et passer de l'époque k à l'époque e le multiplie par
+// factor^(e - k). Une clé n'est remise à l'échelle que lorsqu'elle est touchée.
+void enableTransitionEpochs(t_transition_table *table);
+double transitionCountAtEpoch(t_transition_table table, size_t slot, unsigned epoch, double factor);
+void addDecayedTransition(t_transition_table *table, int from, int to, double weight,
+                          unsigned epoch, double factor);
+// Remettre à l'échelle nb_slots cases à partir de cursor en retirant les
+// comptages inférieurs à threshold ; retourne la case où reprendre
+size_t sweepDecayedTransitions(t_transition_table *table, size_t cursor, int nb_slots,
+                               unsigned epoch, double factor, double threshold);
+void mergeTransitionTables(t_transition_table *dest, t_transition_table src);
+
+// Graphe normalisé (probabilités = comptages / total de la ligne)
+t_adjacency_list transitionTableToAdjacencyList(t_transition_table table, int nb_vertices);
+void writeTransitionGraph(t_transition_table table, int nb_vertices, const char *filename);
+
+// Résultat d'une estimation sur des fichiers de trajectoires
+typedef struct {
+    t_transition_table counts; // Comptages fusionnés
+    int nb_vertices;       // Plus grand état observé
+    long long transitions; // Nombre de transitions lues
+    double seconds;        // Durée de la lecture
+} t_fit_result;
+
+// Compter en parallèle les transitions de fichiers de trajectoires :
+// texte (une trajectoire par ligne, états 1-indexés séparés par des blancs)
+// ou binaire (format écrit par --trajectory, reconnu à son en-tête)
+t_fit_result fitTransitions(const char **filenames, int nb_files);
+void freeFitResult(t_fit_result *result);
+
+#endif // FIT_H
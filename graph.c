@@ -1,8 +1,17 @@
 #include "graph.h"
 #include "utils.h"
+#include "parallel.h"
+#include <pthread.h>
 #include <string.h>
 #include <math.h>
 
+// Index dérivés du graphe, alloués une fois et partagés par les copies de
+// t_adjacency_list (les fonctions reçoivent le graphe par valeur)
+struct s_graph_cache {
+    pthread_mutex_t lock;     // Protège la construction concurrente
+    t_reverse_index *reverse; // Index inverse, NULL tant qu'il n'a pas été demandé
+};
+
 // Créer une cellule
 t_cell *createCell(int destination, float probability) {
     t_cell *cell = (t_cell *)malloc(sizeof(t_cell));
@@ -84,13 +93,40 @@ t_adjacency_list createAdjacencyList(int nb_vertices) {
         adj_list.lists[i].head = NULL;
     }
 
+    adj_list.cache = (t_graph_cache *)malloc(sizeof(t_graph_cache));
+    if (adj_list.cache == NULL) {
+        perror("Failed to allocate memory for graph cache");
+        exit(EXIT_FAILURE);
+    }
+    pthread_mutex_init(&adj_list.cache->lock, NULL);
+    adj_list.cache->reverse = NULL;
+
     return adj_list;
 }
 
+// Libérer l'index inverse
+static void freeReverseIndex(t_reverse_index *index) {
+    if (index == NULL) return;
+    free(index->offsets);
+    free(index->sources);
+    free(index->probabilities);
+    free(index);
+}
+
 // Ajouter une arête
 void addEdge(t_adjacency_list *adj_list, int start, int end, float probability) {
     // Les sommets sont numérotés de 1 à n, on ajuste pour l'indexation (0 à n-1)
     addCellToList(&adj_list->lists[start - 1], end, probability);
+
+    // L'index inverse ne correspond plus au graphe. Modifier le graphe pendant
+    // que d'autres threads le lisent n'est pas permis : le verrou ne sert qu'à
+    // la construction de l'index et n'est pas pris pour chaque arête lue.
+    if (adj_list->cache->reverse != NULL) {
+        pthread_mutex_lock(&adj_list->cache->lock);
+        freeReverseIndex(adj_list->cache->reverse);
+        adj_list->cache->reverse = NULL;
+        pthread_mutex_unlock(&adj_list->cache->lock);
+    }
 }
 
 // Afficher la liste d'adjacence
@@ -114,6 +150,117 @@ void freeAdjacencyList(t_adjacency_list *adj_list) {
         }
     }
     free(adj_list->lists);
+
+    freeReverseIndex(adj_list->cache->reverse);
+    pthread_mutex_destroy(&adj_list->cache->lock);
+    free(adj_list->cache);
+    adj_list->cache = NULL;
+}
+
+// Tri par comptage des arêtes selon leur sommet d'arrivée. Les sommets de départ
+// sont découpés en paquets consécutifs : chaque paquet compte ses arêtes entrantes
+// par sommet, un préfixe donne à chaque paquet sa position d'écriture dans chaque
+// ligne, puis les paquets écrivent en parallèle sans se chevaucher. Les sources
+// restent ainsi triées dans chaque ligne, quel que soit le nombre de threads.
+typedef struct {
+    t_adjacency_list adj_list;
+    int vertices_per_part;
+    int *positions;           // nb_parts x n : comptes, puis positions d'écriture
+    t_reverse_index *index;
+} t_reverse_job;
+
+static void countIncomingTask(int task_index, void *context) {
+    t_reverse_job *job = (t_reverse_job *)context;
+    int n = job->adj_list.nb_vertices;
+    int start = task_index * job->vertices_per_part;
+    int end = min(start + job->vertices_per_part, n);
+    int *counts = &job->positions[(size_t)task_index * n];
+
+    for (int i = start; i < end; i++) {
+        for (t_cell *current = job->adj_list.lists[i].head; current != NULL; current = current->next) {
+            counts[current->destination - 1]++;
+        }
+    }
+}
+
+static void scatterIncomingTask(int task_index, void *context) {
+    t_reverse_job *job = (t_reverse_job *)context;
+    int n = job->adj_list.nb_vertices;
+    int start = task_index * job->vertices_per_part;
+    int end = min(start + job->vertices_per_part, n);
+    int *positions = &job->positions[(size_t)task_index * n];
+
+    for (int i = start; i < end; i++) {
+        for (t_cell *current = job->adj_list.lists[i].head; current != NULL; current = current->next) {
+            int position = positions[current->destination - 1]++;
+            job->index->sources[position] = i;
+            job->index->probabilities[position] = current->probability;
+        }
+    }
+}
+
+static t_reverse_index *buildReverseIndex(t_adjacency_list adj_list) {
+    int n = adj_list.nb_vertices;
+
+    // Un tableau de comptes par paquet : un paquet par thread suffit
+    int nb_parts = n >= 4096 ? getThreadCount() : 1;
+    t_reverse_job job;
+    job.adj_list = adj_list;
+    job.vertices_per_part = (n + nb_parts - 1) / nb_parts;
+    if (job.vertices_per_part < 1) job.vertices_per_part = 1;
+    nb_parts = (n + job.vertices_per_part - 1) / job.vertices_per_part;
+
+    job.index = (t_reverse_index *)malloc(sizeof(t_reverse_index));
+    size_t nb_counts = (size_t)(nb_parts > 0 ? nb_parts : 1) * n;
+    job.positions = (int *)calloc(nb_counts > 0 ? nb_counts : 1, sizeof(int));
+    if (job.index == NULL || job.positions == NULL) {
+        perror("Failed to allocate memory for reverse index");
+        exit(EXIT_FAILURE);
+    }
+    job.index->offsets = (int *)malloc((n + 1) * sizeof(int));
+    if (job.index->offsets == NULL) {
+        perror("Failed to allocate memory for reverse index");
+        exit(EXIT_FAILURE);
+    }
+
+    parallelFor(nb_parts, countIncomingTask, &job);
+
+    // Position de départ de chaque paquet dans chaque ligne
+    job.index->offsets[0] = 0;
+    for (int v = 0; v < n; v++) {
+        int position = job.index->offsets[v];
+        for (int p = 0; p < nb_parts; p++) {
+            int count = job.positions[(size_t)p * n + v];
+            job.positions[(size_t)p * n + v] = position;
+            position += count;
+        }
+        job.index->offsets[v + 1] = position;
+    }
+    job.index->nb_edges = job.index->offsets[n];
+
+    int nb_edges = job.index->nb_edges;
+    job.index->sources = (int *)malloc((nb_edges > 0 ? nb_edges : 1) * sizeof(int));
+    job.index->probabilities = (float *)malloc((nb_edges > 0 ? nb_edges : 1) * sizeof(float));
+    if (job.index->sources == NULL || job.index->probabilities == NULL) {
+        perror("Failed to allocate memory for reverse index");
+        exit(EXIT_FAILURE);
+    }
+
+    parallelFor(nb_parts, scatterIncomingTask, &job);
+
+    free(job.positions);
+    return job.index;
+}
+
+// Obtenir l'index inverse (construit au premier appel)
+const t_reverse_index *getReverseIndex(t_adjacency_list adj_list) {
+    pthread_mutex_lock(&adj_list.cache->lock);
+    if (adj_list.cache->reverse == NULL) {
+        adj_list.cache->reverse = buildReverseIndex(adj_list);
+    }
+    t_reverse_index *index = adj_list.cache->reverse;
+    pthread_mutex_unlock(&adj_list.cache->lock);
+    return index;
 }
 
 // Lire un graphe depuis un fichier
@@ -16,10 +16,23 @@ typedef struct {
     t_cell *head;             // Tête de la liste
 } t_list;
 
+// Index inverse (arêtes entrantes) au format CSR, avec les probabilités.
+// Les prédécesseurs de chaque sommet sont rangés par ordre croissant.
+typedef struct {
+    int *offsets;             // Début des prédécesseurs de chaque sommet (taille n+1)
+    int *sources;             // Prédécesseurs (0-indexés)
+    float *probabilities;     // Probabilité de la transition source -> sommet
+    int nb_edges;             // Nombre d'arêtes
+} t_reverse_index;
+
+// Index dérivés construits à la demande (défini dans graph.c)
+typedef struct s_graph_cache t_graph_cache;
+
 // Structure représentant une liste d'adjacence (le graphe)
 typedef struct {
     t_list *lists;            // Tableau de listes
     int nb_vertices;          // Nombre de sommets
+    t_graph_cache *cache;     // Partagé par toutes les copies de la structure
 } t_adjacency_list;
 
 // Fonctions pour les cellules
@@ -38,6 +51,10 @@ void addEdge(t_adjacency_list *adj_list, int start, int end, float probability);
 void displayAdjacencyList(t_adjacency_list adj_list);
 void freeAdjacencyList(t_adjacency_list *adj_list);
 
+// Index inverse, construit au premier appel par un tri par comptage parallèle
+// puis conservé jusqu'à la prochaine modification du graphe (addEdge)
+const t_reverse_index *getReverseIndex(t_adjacency_list adj_list);
+
 // Fonction de lecture depuis un fichier
 t_adjacency_list readGraph(const char *filename);
 
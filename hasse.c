@@ -137,13 +137,29 @@ void analyzeGraphCharacteristics(t_adjacency_list adj_list, t_partition partitio
     printf("\n=== Caractéristiques du graphe de Markov ===\n\n");
 
     // Déterminer quelles classes sont transitoires ou persistantes
-    int *is_transient = (int *)calloc(partition.nb_classes, sizeof(int));
+    int *is_transient = (int *)calloc(partition.nb_classes > 0 ? partition.nb_classes : 1,
+                                      sizeof(int));
+    if (is_transient == NULL) {
+        perror("Failed to allocate memory for graph characteristics");
+        exit(EXIT_FAILURE);
+    }
 
     // Une classe est transitoire s'il existe un lien sortant
     for (int i = 0; i < links.nb_links; i++) {
         is_transient[links.links[i].from_class] = 1;
     }
 
+    // Parcours arrière depuis chaque classe persistante : qui peut y aboutir
+    int *mark = (int *)malloc((adj_list.nb_vertices > 0 ? adj_list.nb_vertices : 1) * sizeof(int));
+    int *reached = (int *)malloc((adj_list.nb_vertices > 0 ? adj_list.nb_vertices : 1) * sizeof(int));
+    if (mark == NULL || reached == NULL) {
+        perror("Failed to allocate memory for graph characteristics");
+        exit(EXIT_FAILURE);
+    }
+    for (int v = 0; v < adj_list.nb_vertices; v++) {
+        mark[v] = -1;
+    }
+
     // Afficher les classes transitoires et persistantes
     int nb_persistent = 0;
     for (int i = 0; i < partition.nb_classes; i++) {
@@ -162,6 +178,12 @@ void analyzeGraphCharacteristics(t_adjacency_list adj_list, t_partition partitio
             if (partition.classes[i].nb_vertices == 1) {
                 printf("  -> L'état %d est ABSORBANT\n", partition.classes[i].vertices[0]);
             }
+
+            int nb_reaching = collectVerticesReaching(adj_list, partition.classes[i].vertices,
+                                                      partition.classes[i].nb_vertices,
+                                                      mark, i, reached);
+            printf("  -> Atteinte depuis %d état(s) transitoire(s)\n",
+                   nb_reaching - partition.classes[i].nb_vertices);
         }
         printf("\n");
     }
@@ -177,6 +199,8 @@ void analyzeGraphCharacteristics(t_adjacency_list adj_list, t_partition partitio
     printf("\n============================================\n\n");
 
     free(is_transient);
+    free(mark);
+    free(reached);
 }
 
 // ============ Supprimer les liens transitifs (OPTIONNEL) ============
@@ -0,0 +1,314 @@
+#include "hitting.h"
+#include "sparse.h"
+#include "parallel.h"
+#include "utils.h"
+#include <ctype.h>
+#include <math.h>
+#include <string.h>
+
+// ============ Lecture des ensembles cibles ============
+
+static void appendTargetSet(t_target_sets *sets, int *states, int size, int *capacity) {
+    if (sets->nb_sets >= *capacity) {
+        *capacity = *capacity > 0 ? 2 * *capacity : 8;
+        sets->states = (int **)realloc(sets->states, *capacity * sizeof(int *));
+        sets->sizes = (int *)realloc(sets->sizes, *capacity * sizeof(int));
+        if (sets->states == NULL || sets->sizes == NULL) {
+            perror("Failed to reallocate memory for target sets");
+            exit(EXIT_FAILURE);
+        }
+    }
+    sets->states[sets->nb_sets] = states;
+    sets->sizes[sets->nb_sets] = size;
+    sets->nb_sets++;
+}
+
+t_target_sets readTargetSets(const char *filename, int nb_vertices) {
+    FILE *file = fopen(filename, "r");
+    if (file == NULL) {
+        perror("Could not open target sets file");
+        exit(EXIT_FAILURE);
+    }
+
+    t_target_sets sets;
+    memset(&sets, 0, sizeof(sets));
+    int sets_capacity = 0;
+
+    // Lecture caractère par caractère : aucune limite sur la longueur des lignes
+    int *states = NULL;
+    int size = 0;
+    int capacity = 0;
+    long long value = -1;
+    int in_comment = 0;
+    int line = 1;
+    int ch;
+    do {
+        ch = fgetc(file);
+        if (!in_comment && ch != EOF && isdigit(ch)) {
+            value = (value < 0 ? 0 : value) * 10 + (ch - '0');
+            if (value > nb_vertices) value = (long long)nb_vertices + 1;
+            continue;
+        }
+
+        if (value >= 0) {
+            if (value < 1 || value > nb_vertices) {
+                fprintf(stderr, "Error: target state out of range at line %d of %s\n", line, filename);
+                exit(EXIT_FAILURE);
+            }
+            if (size >= capacity) {
+                capacity = capacity > 0 ? 2 * capacity : 16;
+                states = (int *)realloc(states, capacity * sizeof(int));
+                if (states == NULL) {
+                    perror("Failed to reallocate memory for target set");
+                    exit(EXIT_FAILURE);
+                }
+            }
+            states[size++] = (int)value;
+            value = -1;
+        }
+
+        if (ch == '#') {
+            in_comment = 1;
+        } else if (ch == '\n' || ch == EOF) {
+            if (size > 0) {
+                appendTargetSet(&sets, states, size, &sets_capacity);
+                states = NULL;
+                size = capacity = 0;
+            }
+            in_comment = 0;
+            line++;
+        } else if (!in_comment && ch != ',' && !isspace(ch)) {
+            fprintf(stderr, "Error: unexpected character '%c' at line %d of %s\n", ch, line, filename);
+            exit(EXIT_FAILURE);
+        }
+    } while (ch != EOF);
+
+    fclose(file);
+    free(states);
+
+    if (sets.nb_sets == 0) {
+        fprintf(stderr, "Error: no target set in %s\n", filename);
+        exit(EXIT_FAILURE);
+    }
+    return sets;
+}
+
+void freeTargetSets(t_target_sets *sets) {
+    for (int s = 0; s < sets->nb_sets; s++) {
+        free(sets->states[s]);
+    }
+    free(sets->states);
+    free(sets->sizes);
+    sets->states = NULL;
+    sets->sizes = NULL;
+    sets->nb_sets = 0;
+}
+
+// ============ Loi du premier instant d'atteinte ============
+
+// Paquet d'au plus SPMM_MAX_VECTORS ensembles avançant dans le même SpMM
+typedef struct {
+    int first_set;         // Indice du premier ensemble du paquet
+    int width;             // Nombre d'ensembles (colonnes) du paquet
+    double *current;       // Masse non absorbée, n lignes de width valeurs
+    double *next;          // Résultat du pas suivant
+    size_t *target_index;  // Position (état * width + colonne) de chaque cible
+    int nb_targets;        // Nombre total de cibles du paquet
+} t_hitting_batch;
+
+t_hitting_options defaultHittingOptions() {
+    t_hitting_options options;
+    options.horizon = HITTING_DEFAULT_HORIZON;
+    options.start = 0;
+    options.output_file = NULL;
+    return options;
+}
+
+// Retirer la masse arrivée sur les cibles et l'ajouter à hit (une valeur par colonne)
+static void absorbTargets(t_hitting_batch *batch, double *vector, double *hit) {
+    for (int s = 0; s < batch->width; s++) {
+        hit[s] = 0.0;
+    }
+    for (int t = 0; t < batch->nb_targets; t++) {
+        size_t index = batch->target_index[t];
+        hit[index % batch->width] += vector[index];
+        vector[index] = 0.0;
+    }
+}
+
+t_hitting_result computeHittingTimes(t_adjacency_list adj_list, t_target_sets sets,
+                                     t_hitting_options options, const int *vertex_map) {
+    int n = adj_list.nb_vertices;
+    int nb_sets = sets.nb_sets;
+    if (options.horizon < 0) {
+        fprintf(stderr, "Error: hitting time horizon must be non-negative\n");
+        exit(EXIT_FAILURE);
+    }
+    if (options.start < 0 || options.start > n) {
+        fprintf(stderr, "Error: start state %d out of range\n", options.start);
+        exit(EXIT_FAILURE);
+    }
+
+    FILE *output = stdout;
+    if (options.output_file != NULL) {
+        output = fopen(options.output_file, "w");
+        if (output == NULL) {
+            perror("Could not open hitting times output file");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    double start_time = getWallTime();
+
+    // x P = (P^T x^T)^T : le SpMM sur la transposée fait avancer les distributions
+    t_csr_matrix transposed = adjacencyListToTransposedCSR(adj_list);
+
+    int nb_batches = (nb_sets + SPMM_MAX_VECTORS - 1) / SPMM_MAX_VECTORS;
+    t_hitting_batch *batches = (t_hitting_batch *)calloc(nb_batches, sizeof(t_hitting_batch));
+    double *step_mass = (double *)malloc(nb_sets * sizeof(double));
+    double *remaining = (double *)malloc(nb_sets * sizeof(double));
+    double *weighted_time = (double *)calloc(nb_sets, sizeof(double));
+    t_hitting_result result;
+    result.nb_sets = nb_sets;
+    result.steps = 0;
+    result.hit_probability = (double *)calloc(nb_sets, sizeof(double));
+    result.mean_hit_time = (double *)calloc(nb_sets, sizeof(double));
+    if (batches == NULL || step_mass == NULL || remaining == NULL || weighted_time == NULL ||
+        result.hit_probability == NULL || result.mean_hit_time == NULL) {
+        perror("Failed to allocate memory for hitting times");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int b = 0; b < nb_batches; b++) {
+        t_hitting_batch *batch = &batches[b];
+        batch->first_set = b * SPMM_MAX_VECTORS;
+        batch->width = min(SPMM_MAX_VECTORS, nb_sets - batch->first_set);
+        size_t size = (size_t)n * batch->width;
+        batch->current = (double *)malloc((size > 0 ? size : 1) * sizeof(double));
+        batch->next = (double *)malloc((size > 0 ? size : 1) * sizeof(double));
+
+        for (int s = 0; s < batch->width; s++) {
+            batch->nb_targets += sets.sizes[batch->first_set + s];
+        }
+        batch->target_index = (size_t *)malloc(batch->nb_targets * sizeof(size_t));
+        if (batch->current == NULL || batch->next == NULL || batch->target_index == NULL) {
+            perror("Failed to allocate memory for hitting time batch");
+            exit(EXIT_FAILURE);
+        }
+        int t = 0;
+        for (int s = 0; s < batch->width; s++) {
+            int set = batch->first_set + s;
+            for (int k = 0; k < sets.sizes[set]; k++) {
+                int state = sets.states[set][k] - 1;
+                if (vertex_map != NULL) state = vertex_map[state];
+                batch->target_index[t++] = (size_t)state * batch->width + s;
+            }
+        }
+
+        // Distribution initiale identique pour tous les ensembles du paquet
+        double initial = options.start > 0 ? 0.0 : 1.0 / n;
+        for (size_t i = 0; i < size; i++) {
+            batch->current[i] = initial;
+        }
+        if (options.start > 0) {
+            int start = vertex_map != NULL ? vertex_map[options.start - 1] : options.start - 1;
+            for (int s = 0; s < batch->width; s++) {
+                batch->current[(size_t)start * batch->width + s] = 1.0;
+            }
+        }
+    }
+    for (int s = 0; s < nb_sets; s++) {
+        remaining[s] = 1.0;
+    }
+
+    fprintf(output, "# pas");
+    for (int s = 0; s < nb_sets; s++) {
+        fprintf(output, " P(T%d)", s + 1);
+    }
+    fprintf(output, "\n");
+
+    // Pas 0 : la masse initiale déjà sur les cibles ; puis un SpMM par paquet et par pas
+    for (int k = 0; k <= options.horizon; k++) {
+        double largest_remaining = 0.0;
+        for (int b = 0; b < nb_batches; b++) {
+            t_hitting_batch *batch = &batches[b];
+            if (k > 0) {
+                csrMultiplyBlock(transposed, batch->current, batch->next, batch->width);
+                double *swap = batch->current;
+                batch->current = batch->next;
+                batch->next = swap;
+            }
+            absorbTargets(batch, batch->current, &step_mass[batch->first_set]);
+        }
+
+        fprintf(output, "%d", k);
+        for (int s = 0; s < nb_sets; s++) {
+            fprintf(output, " %.10e", step_mass[s]);
+            result.hit_probability[s] += step_mass[s];
+            weighted_time[s] += (double)k * step_mass[s];
+            remaining[s] -= step_mass[s];
+            if (remaining[s] > largest_remaining) largest_remaining = remaining[s];
+        }
+        fprintf(output, "\n");
+        result.steps = k;
+
+        // Toute la masse est absorbée : les pas suivants seraient nuls
+        if (largest_remaining < HITTING_MASS_EPSILON) {
+            break;
+        }
+    }
+
+    for (int s = 0; s < nb_sets; s++) {
+        if (result.hit_probability[s] > 0.0) {
+            result.mean_hit_time[s] = weighted_time[s] / result.hit_probability[s];
+        }
+    }
+    result.seconds = getWallTime() - start_time;
+
+    if (output != stdout) {
+        fclose(output);
+    }
+    for (int b = 0; b < nb_batches; b++) {
+        free(batches[b].current);
+        free(batches[b].next);
+        free(batches[b].target_index);
+    }
+    free(batches);
+    free(step_mass);
+    free(remaining);
+    free(weighted_time);
+    freeCSRMatrix(&transposed);
+    return result;
+}
+
+void displayHittingResult(t_hitting_result result, t_target_sets sets) {
+    printf("\n=== Temps d'atteinte des ensembles cibles (%d pas) ===\n\n", result.steps);
+    printf("Ensemble  P(tau <= %d)  E[tau | tau <= %d]  États\n", result.steps, result.steps);
+    for (int s = 0; s < result.nb_sets; s++) {
+        printf("T%-7d  %12.6f  ", s + 1, result.hit_probability[s]);
+        if (result.hit_probability[s] > 0.0) {
+            printf("%18.4f", result.mean_hit_time[s]);
+        } else {
+            printf("%18s", "-");
+        }
+
+        int nb_displayed = min(sets.sizes[s], 8);
+        printf("  {");
+        for (int k = 0; k < nb_displayed; k++) {
+            printf(k == 0 ? "%d" : ",%d", sets.states[s][k]);
+        }
+        if (sets.sizes[s] > nb_displayed) {
+            printf(",... (%d états)", sets.sizes[s]);
+        }
+        printf("}\n");
+    }
+    printf("Calcul: %.3f s\n", result.seconds);
+    printf("=====================================================\n\n");
+}
+
+void freeHittingResult(t_hitting_result *result) {
+    free(result->hit_probability);
+    free(result->mean_hit_time);
+    result->hit_probability = NULL;
+    result->mean_hit_time = NULL;
+}
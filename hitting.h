@@ -0,0 +1,52 @@
+#ifndef HITTING_H
+#define HITTING_H
+
+#include "graph.h"
+
+// Horizon par défaut des temps d'atteinte
+#define HITTING_DEFAULT_HORIZON 100
+
+// Masse restante en dessous de laquelle les pas suivants sont tous nuls
+#define HITTING_MASS_EPSILON 1e-15
+
+// Ensembles d'états cibles (une ligne du fichier par ensemble)
+typedef struct {
+    int **states;          // États de chaque ensemble (1-indexés)
+    int *sizes;            // Nombre d'états de chaque ensemble
+    int nb_sets;           // Nombre d'ensembles
+} t_target_sets;
+
+// Paramètres du calcul des temps d'atteinte
+typedef struct {
+    int horizon;           // Nombre maximal de pas
+    int start;             // État de départ (0 = distribution uniforme)
+    const char *output_file; // Fichier des masses par pas (NULL = sortie standard)
+} t_hitting_options;
+
+// Bilan par ensemble cible, les masses par pas étant écrites au fil du calcul
+typedef struct {
+    int nb_sets;           // Nombre d'ensembles cibles
+    int steps;             // Nombre de pas effectivement calculés
+    double *hit_probability; // P(tau_T <= steps)
+    double *mean_hit_time; // E[tau_T | tau_T <= steps]
+    double seconds;        // Durée du calcul
+} t_hitting_result;
+
+// Lecture des ensembles cibles : états séparés par des blancs ou des virgules,
+// '#' commence un commentaire, les lignes vides sont ignorées
+t_target_sets readTargetSets(const char *filename, int nb_vertices);
+void freeTargetSets(t_target_sets *sets);
+
+// Loi du premier instant d'atteinte : P(tau_T = k) pour k = 0..horizon et
+// pour chaque ensemble T. Les cibles sont rendues absorbantes (la masse qui
+// les atteint est retirée du vecteur) et jusqu'à SPMM_MAX_VECTORS ensembles
+// avancent ensemble dans un même produit creux par blocs.
+t_hitting_options defaultHittingOptions();
+// vertex_map donne le numéro dans adj_list (0-indexé) de chaque état d'origine
+// quand le graphe a été renuméroté (NULL = même numérotation).
+t_hitting_result computeHittingTimes(t_adjacency_list adj_list, t_target_sets sets,
+                                     t_hitting_options options, const int *vertex_map);
+void displayHittingResult(t_hitting_result result, t_target_sets sets);
+void freeHittingResult(t_hitting_result *result);
+
+#endif // HITTING_H
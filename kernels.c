@@ -0,0 +1,193 @@
+#include "kernels.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+
+// ============ Génération des noyaux par taille ============
+
+#define DEFINE_SMALL_KERNELS(N)                                                     \
+static void multiplySmall##N(float **a, float **b, float **result) {               \
+    float la[N][N], lb[N][N];                                                       \
+    for (int i = 0; i < N; i++) {                                                   \
+        for (int j = 0; j < N; j++) {                                               \
+            la[i][j] = a[i][j];                                                     \
+            lb[i][j] = b[i][j];                                                     \
+        }                                                                           \
+    }                                                                               \
+    for (int i = 0; i < N; i++) {                                                   \
+        for (int j = 0; j < N; j++) {                                               \
+            float sum = 0.0f;                                                       \
+            for (int k = 0; k < N; k++) {                                           \
+                sum += la[i][k] * lb[k][j];                                         \
+            }                                                                       \
+            result[i][j] = sum;                                                     \
+        }                                                                           \
+    }                                                                               \
+}                                                                                   \
+                                                                                    \
+static void copySmall##N(float **dest, float **src) {                               \
+    for (int i = 0; i < N; i++) {                                                   \
+        for (int j = 0; j < N; j++) {                                               \
+            dest[i][j] = src[i][j];                                                 \
+        }                                                                           \
+    }                                                                               \
+}                                                                                   \
+                                                                                    \
+static float differenceSmall##N(float **m, float **p) {                             \
+    float diff = 0.0f;                                                              \
+    for (int i = 0; i < N; i++) {                                                   \
+        for (int j = 0; j < N; j++) {                                               \
+            diff += fabsf(m[i][j] - p[i][j]);                                       \
+        }                                                                           \
+    }                                                                               \
+    return diff;                                                                    \
+}                                                                                   \
+                                                                                    \
+static int powersSmall##N(float **matrix, float epsilon, int max_power,             \
+                          float *first_row, float *difference) {                    \
+    float base[N][N], prev[N][N], next[N][N];                                       \
+    for (int i = 0; i < N; i++) {                                                   \
+        for (int j = 0; j < N; j++) {                                               \
+            base[i][j] = matrix[i][j];                                              \
+            prev[i][j] = matrix[i][j];                                              \
+        }                                                                           \
+    }                                                                               \
+    int power = 1;                                                                  \
+    float diff;                                                                     \
+    do {                                                                            \
+        power++;                                                                    \
+        diff = 0.0f;                                                                \
+        for (int i = 0; i < N; i++) {                                               \
+            for (int j = 0; j < N; j++) {                                           \
+                float sum = 0.0f;                                                   \
+                for (int k = 0; k < N; k++) {                                       \
+                    sum += prev[i][k] * base[k][j];                                 \
+                }                                                                   \
+                next[i][j] = sum;                                                   \
+            }                                                                       \
+        }                                                                           \
+        for (int i = 0; i < N; i++) {                                               \
+            for (int j = 0; j < N; j++) {                                           \
+                diff += fabsf(next[i][j] - prev[i][j]);                             \
+                prev[i][j] = next[i][j];                                            \
+            }                                                                       \
+        }                                                                           \
+        if (power > max_power) break;                                               \
+    } while (diff > epsilon);                                                       \
+    for (int j = 0; j < N; j++) {                                                   \
+        first_row[j] = prev[0][j];                                                  \
+    }                                                                               \
+    *difference = diff;                                                             \
+    return power;                                                                   \
+}
+
+DEFINE_SMALL_KERNELS(1)
+DEFINE_SMALL_KERNELS(2)
+DEFINE_SMALL_KERNELS(3)
+DEFINE_SMALL_KERNELS(4)
+DEFINE_SMALL_KERNELS(5)
+DEFINE_SMALL_KERNELS(6)
+DEFINE_SMALL_KERNELS(7)
+DEFINE_SMALL_KERNELS(8)
+DEFINE_SMALL_KERNELS(9)
+DEFINE_SMALL_KERNELS(10)
+DEFINE_SMALL_KERNELS(11)
+DEFINE_SMALL_KERNELS(12)
+DEFINE_SMALL_KERNELS(13)
+DEFINE_SMALL_KERNELS(14)
+DEFINE_SMALL_KERNELS(15)
+DEFINE_SMALL_KERNELS(16)
+
+// ============ Tables de répartition par taille ============
+
+typedef void (*t_multiply_kernel)(float **, float **, float **);
+typedef void (*t_copy_kernel)(float **, float **);
+typedef float (*t_difference_kernel)(float **, float **);
+typedef int (*t_powers_kernel)(float **, float, int, float *, float *);
+
+#define KERNEL_TABLE(name) {                                                        \
+    NULL, name##1, name##2, name##3, name##4, name##5, name##6, name##7, name##8,    \
+    name##9, name##10, name##11, name##12, name##13, name##14, name##15, name##16    \
+}
+
+static const t_multiply_kernel multiply_kernels[SMALL_KERNEL_MAX + 1] = KERNEL_TABLE(multiplySmall);
+static const t_copy_kernel copy_kernels[SMALL_KERNEL_MAX + 1] = KERNEL_TABLE(copySmall);
+static const t_difference_kernel difference_kernels[SMALL_KERNEL_MAX + 1] = KERNEL_TABLE(differenceSmall);
+static const t_powers_kernel powers_kernels[SMALL_KERNEL_MAX + 1] = KERNEL_TABLE(powersSmall);
+
+int hasSmallKernel(int n) {
+    return n >= 1 && n <= SMALL_KERNEL_MAX;
+}
+
+void multiplySmall(int n, float **a, float **b, float **result) {
+    multiply_kernels[n](a, b, result);
+}
+
+void copySmall(int n, float **dest, float **src) {
+    copy_kernels[n](dest, src);
+}
+
+float differenceSmall(int n, float **m, float **p) {
+    return difference_kernels[n](m, p);
+}
+
+int powersSmall(int n, float **matrix, float epsilon, int max_power,
+                float *first_row, float *difference) {
+    return powers_kernels[n](matrix, epsilon, max_power, first_row, difference);
+}
+
+// ============ Période par masques de bits ============
+
+static int gcdSmall(int a, int b) {
+    while (b != 0) {
+        int temp = b;
+        b = a % b;
+        a = temp;
+    }
+    return a;
+}
+
+// Chaque ligne tient dans un mot de 16 bits : le parcours en largeur avance
+// d'un niveau entier par itération en combinant les masques des successeurs
+int periodSmall(int n, const uint32_t *succ) {
+    int level[SMALL_KERNEL_MAX];
+
+    for (int i = 0; i < n; i++) {
+        level[i] = -1;
+    }
+
+    uint32_t visited = 1u;
+    uint32_t frontier = 1u;
+    int depth = 0;
+    level[0] = 0;
+    while (frontier != 0) {
+        uint32_t next = 0;
+        for (int u = 0; u < n; u++) {
+            if (frontier & ((uint32_t)1 << u)) {
+                next |= succ[u];
+            }
+        }
+        next &= ~visited;
+        depth++;
+        for (int v = 0; v < n; v++) {
+            if (next & ((uint32_t)1 << v)) {
+                level[v] = depth;
+            }
+        }
+        visited |= next;
+        frontier = next;
+    }
+
+    int period = 0;
+    for (int u = 0; u < n; u++) {
+        if (level[u] == -1) continue;
+        for (int v = 0; v < n; v++) {
+            if ((succ[u] & ((uint32_t)1 << v)) && level[v] != -1) {
+                int gap = level[u] + 1 - level[v];
+                period = gcdSmall(period, gap < 0 ? -gap : gap);
+            }
+        }
+    }
+
+    return period;
+}
@@ -0,0 +1,30 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <stdint.h>
+
+// Taille maximale des classes traitées par les noyaux spécialisés
+#define SMALL_KERNEL_MAX 16
+
+// Les noyaux sont générés pour chaque taille n <= SMALL_KERNEL_MAX : les boucles
+// ont des bornes constantes et les matrices tiennent dans des tableaux locaux,
+// que le compilateur déroule et garde en registres.
+
+// Indique si un noyau spécialisé existe pour la taille n
+int hasSmallKernel(int n);
+
+// Opérations matricielles n x n (mêmes résultats que les versions génériques)
+void multiplySmall(int n, float **a, float **b, float **result);
+void copySmall(int n, float **dest, float **src);
+float differenceSmall(int n, float **m, float **p);
+
+// Puissances successives jusqu'à différence <= epsilon (ou power > max_power)
+// Retourne la dernière puissance calculée, first_row reçoit la première ligne de M^power
+int powersSmall(int n, float **matrix, float epsilon, int max_power,
+                float *first_row, float *difference);
+
+// Période d'une classe de n états (pgcd des longueurs de cycles), succ[i] étant
+// le masque des successeurs de l'état i dans la classe
+int periodSmall(int n, const uint32_t *succ);
+
+#endif // KERNELS_H
@@ -0,0 +1,294 @@
+#include "limit.h"
+#include "matrix.h"
+#include "utils.h"
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+
+// ============ Assemblage par blocs ============
+
+// Coefficient d'une classe persistante, trié par numéro d'état
+typedef struct {
+    int state;
+    double probability;
+} t_limit_entry;
+
+static int compareLimitEntries(const void *a, const void *b) {
+    const t_limit_entry *ea = (const t_limit_entry *)a;
+    const t_limit_entry *eb = (const t_limit_entry *)b;
+    return (ea->state > eb->state) - (ea->state < eb->state);
+}
+
+// Les blocs diagonaux persistants ne sont jamais recalculés : Pi_k est la
+// distribution stationnaire déjà obtenue pour la classe, et chaque ligne
+// transitoire ne fait que pondérer ces blocs par la ligne de B = N R, elle-même
+// obtenue classe transitoire par classe transitoire (computeAbsorption).
+t_limit_result computeLimitMatrix(t_partition partition, int nb_vertices, float **distributions,
+                                  t_absorption_result absorption) {
+    t_limit_result result;
+    memset(&result, 0, sizeof(result));
+    result.nb_vertices = nb_vertices;
+    result.nb_persistent = absorption.nb_persistent;
+
+    int nb_persistent = absorption.nb_persistent;
+    result.persistent_classes = (int *)malloc((nb_persistent > 0 ? nb_persistent : 1) * sizeof(int));
+    result.class_start = (int *)malloc((nb_persistent + 1) * sizeof(int));
+    if (result.persistent_classes == NULL || result.class_start == NULL) {
+        perror("Failed to allocate memory for limit matrix");
+        exit(EXIT_FAILURE);
+    }
+
+    // Blocs persistants : états triés avec leur probabilité stationnaire
+    int nb_persistent_states = 0;
+    for (int k = 0; k < nb_persistent; k++) {
+        int c = absorption.persistent_classes[k];
+        if (distributions[c] == NULL) {
+            fprintf(stderr, "Error: missing stationary distribution for class C%d\n", c + 1);
+            exit(EXIT_FAILURE);
+        }
+        result.persistent_classes[k] = c;
+        result.class_start[k] = nb_persistent_states;
+        nb_persistent_states += partition.classes[c].nb_vertices;
+    }
+    result.class_start[nb_persistent] = nb_persistent_states;
+
+    int slots = nb_persistent_states > 0 ? nb_persistent_states : 1;
+    t_limit_entry *entries = (t_limit_entry *)malloc(slots * sizeof(t_limit_entry));
+    result.states = (int *)malloc(slots * sizeof(int));
+    result.distribution = (double *)malloc(slots * sizeof(double));
+    if (entries == NULL || result.states == NULL || result.distribution == NULL) {
+        perror("Failed to allocate memory for limit matrix");
+        exit(EXIT_FAILURE);
+    }
+    for (int k = 0; k < nb_persistent; k++) {
+        t_class *classe = &partition.classes[result.persistent_classes[k]];
+        t_limit_entry *block = &entries[result.class_start[k]];
+        for (int i = 0; i < classe->nb_vertices; i++) {
+            block[i].state = classe->vertices[i];
+            block[i].probability = distributions[result.persistent_classes[k]][i];
+        }
+        qsort(block, classe->nb_vertices, sizeof(t_limit_entry), compareLimitEntries);
+    }
+    for (int s = 0; s < nb_persistent_states; s++) {
+        result.states[s] = entries[s].state;
+        result.distribution[s] = entries[s].probability;
+    }
+    free(entries);
+
+    // Ligne de chaque état : sa propre classe s'il est persistant, sinon sa
+    // ligne de la matrice d'absorption (classes atteintes avec une probabilité non nulle)
+    int *vertex_to_class = createVertexToClassMap(partition, nb_vertices);
+    int *class_to_persistent = (int *)malloc((partition.nb_classes > 0 ? partition.nb_classes : 1) *
+                                             sizeof(int));
+    int *vertex_to_row = (int *)malloc((nb_vertices > 0 ? nb_vertices : 1) * sizeof(int));
+    result.row_start = (int *)calloc(nb_vertices + 1, sizeof(int));
+    if (class_to_persistent == NULL || vertex_to_row == NULL || result.row_start == NULL) {
+        perror("Failed to allocate memory for limit matrix");
+        exit(EXIT_FAILURE);
+    }
+    for (int c = 0; c < partition.nb_classes; c++) {
+        class_to_persistent[c] = -1;
+    }
+    for (int k = 0; k < nb_persistent; k++) {
+        class_to_persistent[result.persistent_classes[k]] = k;
+    }
+    for (int v = 0; v < nb_vertices; v++) {
+        vertex_to_row[v] = -1;
+    }
+    for (int row = 0; row < absorption.nb_transient; row++) {
+        vertex_to_row[absorption.transient_states[row] - 1] = row;
+    }
+
+    for (int v = 0; v < nb_vertices; v++) {
+        int count = 0;
+        if (vertex_to_row[v] < 0) {
+            count = 1;
+        } else {
+            const double *b = &absorption.probabilities[(size_t)vertex_to_row[v] * nb_persistent];
+            for (int k = 0; k < nb_persistent; k++) {
+                if (b[k] > LIMIT_WEIGHT_EPSILON) count++;
+            }
+        }
+        result.row_start[v + 1] = result.row_start[v] + count;
+    }
+
+    int nb_weights = result.row_start[nb_vertices];
+    result.row_class = (int *)malloc((nb_weights > 0 ? nb_weights : 1) * sizeof(int));
+    result.row_weight = (double *)malloc((nb_weights > 0 ? nb_weights : 1) * sizeof(double));
+    if (result.row_class == NULL || result.row_weight == NULL) {
+        perror("Failed to allocate memory for limit matrix");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int v = 0; v < nb_vertices; v++) {
+        int position = result.row_start[v];
+        if (vertex_to_row[v] < 0) {
+            int k = class_to_persistent[vertex_to_class[v]];
+            if (k < 0) {
+                fprintf(stderr, "Error: state %d is neither transient nor persistent\n", v + 1);
+                exit(EXIT_FAILURE);
+            }
+            result.row_class[position] = k;
+            result.row_weight[position] = 1.0;
+            result.nnz += result.class_start[k + 1] - result.class_start[k];
+            continue;
+        }
+        const double *b = &absorption.probabilities[(size_t)vertex_to_row[v] * nb_persistent];
+        for (int k = 0; k < nb_persistent; k++) {
+            if (b[k] <= LIMIT_WEIGHT_EPSILON) continue;
+            result.row_class[position] = k;
+            result.row_weight[position] = b[k];
+            result.nnz += result.class_start[k + 1] - result.class_start[k];
+            position++;
+        }
+    }
+
+    free(vertex_to_class);
+    free(class_to_persistent);
+    free(vertex_to_row);
+
+    return result;
+}
+
+// ============ Forme creuse ============
+
+t_csr_matrix limitMatrixToCSR(t_limit_result result) {
+    if (result.nnz > INT_MAX) {
+        fprintf(stderr, "Error: limit matrix has too many nonzeros for CSR storage\n");
+        exit(EXIT_FAILURE);
+    }
+
+    int n = result.nb_vertices;
+    t_csr_matrix matrix = createCSRMatrix(n, n, (int)result.nnz);
+    t_limit_entry *row = (t_limit_entry *)malloc((n > 0 ? n : 1) * sizeof(t_limit_entry));
+    if (row == NULL) {
+        perror("Failed to allocate memory for limit matrix row");
+        exit(EXIT_FAILURE);
+    }
+
+    int position = 0;
+    for (int i = 0; i < n; i++) {
+        int length = 0;
+        for (int w = result.row_start[i]; w < result.row_start[i + 1]; w++) {
+            int k = result.row_class[w];
+            for (int s = result.class_start[k]; s < result.class_start[k + 1]; s++) {
+                row[length].state = result.states[s];
+                row[length].probability = result.row_weight[w] * result.distribution[s];
+                length++;
+            }
+        }
+        // Une seule classe : ses états sont déjà croissants
+        if (result.row_start[i + 1] - result.row_start[i] > 1) {
+            qsort(row, length, sizeof(t_limit_entry), compareLimitEntries);
+        }
+        for (int j = 0; j < length; j++) {
+            matrix.col_idx[position] = row[j].state - 1;
+            matrix.values[position] = (float)row[j].probability;
+            position++;
+        }
+        matrix.row_ptr[i + 1] = position;
+    }
+
+    free(row);
+    return matrix;
+}
+
+// ============ Affichage et écriture ============
+
+void displayLimitResult(t_limit_result result) {
+    printf("\n=== Matrice limite (une ligne par état de départ) ===\n\n");
+
+    int n = result.nb_vertices;
+    double density = n > 0 ? 100.0 * (double)result.nnz / ((double)n * n) : 0.0;
+    printf("%d classe(s) persistante(s), %zu coefficients non nuls (%.2f%% de la matrice)\n",
+           result.nb_persistent, result.nnz, density);
+
+    // Somme de chaque ligne : somme_k w_ik (somme de Pi_k) doit valoir 1
+    double *class_mass = (double *)calloc(result.nb_persistent > 0 ? result.nb_persistent : 1,
+                                          sizeof(double));
+    if (class_mass == NULL) {
+        perror("Failed to allocate memory for limit matrix summary");
+        exit(EXIT_FAILURE);
+    }
+    for (int k = 0; k < result.nb_persistent; k++) {
+        for (int s = result.class_start[k]; s < result.class_start[k + 1]; s++) {
+            class_mass[k] += result.distribution[s];
+        }
+    }
+    double worst_sum_error = 0.0;
+    for (int i = 0; i < n; i++) {
+        double sum = 0.0;
+        for (int w = result.row_start[i]; w < result.row_start[i + 1]; w++) {
+            sum += result.row_weight[w] * class_mass[result.row_class[w]];
+        }
+        if (fabs(sum - 1.0) > worst_sum_error) worst_sum_error = fabs(sum - 1.0);
+    }
+    free(class_mass);
+
+    if (n <= MATRIX_DISPLAY_MAX) {
+        t_csr_matrix sparse = limitMatrixToCSR(result);
+        t_matrix dense = csrToMatrix(sparse);
+        displayMatrix(dense);
+        freeMatrix(&dense);
+        freeCSRMatrix(&sparse);
+    } else {
+        // Forme factorisée des premières lignes : classes atteintes et leur poids
+        printf("\n");
+        int nb_displayed = min(n, MATRIX_DISPLAY_MAX);
+        for (int i = 0; i < nb_displayed; i++) {
+            printf("État %d ->", i + 1);
+            for (int w = result.row_start[i]; w < result.row_start[i + 1]; w++) {
+                printf(" %.4f Pi(C%d)", result.row_weight[w],
+                       result.persistent_classes[result.row_class[w]] + 1);
+            }
+            printf("\n");
+        }
+        printf("... (%d autres états)\n\n", n - nb_displayed);
+    }
+
+    printf("Écart maximal de la somme d'une ligne à 1: %.3e\n", worst_sum_error);
+    printf("=====================================================\n\n");
+}
+
+void writeLimitMatrix(t_limit_result result, const char *filename) {
+    FILE *output = fopen(filename, "w");
+    if (output == NULL) {
+        perror("Could not open limit matrix output file");
+        exit(EXIT_FAILURE);
+    }
+
+    fprintf(output, "# départ état:probabilité...\n");
+    for (int i = 0; i < result.nb_vertices; i++) {
+        fprintf(output, "%d", i + 1);
+        for (int w = result.row_start[i]; w < result.row_start[i + 1]; w++) {
+            int k = result.row_class[w];
+            for (int s = result.class_start[k]; s < result.class_start[k + 1]; s++) {
+                double value = result.row_weight[w] * result.distribution[s];
+                if (value != 0.0) {
+                    fprintf(output, " %d:%.10e", result.states[s], value);
+                }
+            }
+        }
+        fprintf(output, "\n");
+    }
+
+    fclose(output);
+    printf("Matrice limite écrite dans %s\n", filename);
+}
+
+void freeLimitResult(t_limit_result *result) {
+    free(result->persistent_classes);
+    free(result->class_start);
+    free(result->states);
+    free(result->distribution);
+    free(result->row_start);
+    free(result->row_class);
+    free(result->row_weight);
+    result->persistent_classes = NULL;
+    result->class_start = NULL;
+    result->states = NULL;
+    result->distribution = NULL;
+    result->row_start = NULL;
+    result->row_class = NULL;
+    result->row_weight = NULL;
+}
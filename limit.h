@@ -0,0 +1,48 @@
+#ifndef LIMIT_H
+#define LIMIT_H
+
+#include "graph.h"
+#include "tarjan.h"
+#include "absorption.h"
+#include "sparse.h"
+
+// Probabilité d'absorption en dessous de laquelle une classe est omise d'une ligne
+#define LIMIT_WEIGHT_EPSILON 1e-12
+
+// Matrice limite L = lim (1/n) somme M^k, rangée sous forme factorisée : la
+// ligne de l'état i vaut somme_k w_ik Pi_k, où Pi_k est la distribution
+// stationnaire de la k-ième classe persistante et w_ik la probabilité d'y
+// finir depuis i. Seules les colonnes des classes persistantes sont non nulles.
+typedef struct {
+    int nb_vertices;       // Nombre d'états (lignes de la matrice limite)
+    int nb_persistent;     // Nombre de classes persistantes
+    int *persistent_classes; // Indice de chaque classe persistante dans la partition
+    int *class_start;      // Début de chaque classe persistante dans states (nb_persistent + 1)
+    int *states;           // États des classes persistantes (1-indexés, croissants par classe)
+    double *distribution;  // Pi de la classe de chaque entrée de states
+    int *row_start;        // Début des poids de chaque ligne (nb_vertices + 1)
+    int *row_class;        // Classe persistante (0..nb_persistent-1) de chaque poids
+    double *row_weight;    // Probabilité de finir dans cette classe
+    size_t nnz;            // Nombre de coefficients non nuls de L
+} t_limit_result;
+
+// Assemblage par blocs dans l'ordre des classes de Tarjan (P triangulaire par
+// blocs) : chaque bloc persistant n'est résolu qu'une fois (distributions, une
+// par classe dans l'ordre de ses sommets, NULL pour les classes transitoires,
+// telles que rendues par computeStationaryDistribution) et les blocs
+// transitoires propagent les poids des classes qu'ils atteignent (absorption).
+// Pour une classe périodique, la limite est celle de Cesàro.
+t_limit_result computeLimitMatrix(t_partition partition, int nb_vertices, float **distributions,
+                                  t_absorption_result absorption);
+
+// Conversion en matrice creuse nb_vertices x nb_vertices (colonnes triées)
+t_csr_matrix limitMatrixToCSR(t_limit_result result);
+
+void displayLimitResult(t_limit_result result);
+
+// Une ligne "i j:p j:p ..." par état de départ (numéros 1-indexés)
+void writeLimitMatrix(t_limit_result result, const char *filename);
+
+void freeLimitResult(t_limit_result *result);
+
+#endif // LIMIT_H
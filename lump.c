@@ -0,0 +1,521 @@
+#include "lump.h"
+#include "matrix.h"
+#include "parallel.h"
+#include "utils.h"
+#include <math.h>
+#include <string.h>
+
+// ============ Raffinement de partition ============
+
+// Clés quantifiées d'un état touché par le séparateur courant
+typedef struct {
+    long long out_key;     // round(P(i, C) / LUMP_TOLERANCE)
+    long long in_key;      // round(somme_{k dans C} P(k, i) / LUMP_TOLERANCE)
+    int state;             // État (0-indexé)
+} t_lump_key;
+
+static int compareLumpKeys(const void *a, const void *b) {
+    const t_lump_key *ka = (const t_lump_key *)a;
+    const t_lump_key *kb = (const t_lump_key *)b;
+    if (ka->out_key != kb->out_key) return ka->out_key < kb->out_key ? -1 : 1;
+    if (ka->in_key != kb->in_key) return ka->in_key < kb->in_key ? -1 : 1;
+    return (ka->state > kb->state) - (ka->state < kb->state);
+}
+
+static int sameLumpKey(t_lump_key a, t_lump_key b) {
+    return a.out_key == b.out_key && a.in_key == b.in_key;
+}
+
+// Les blocs sont des intervalles [start, end) du tableau elements. Un état
+// touché par le séparateur est aussitôt déplacé en fin de son bloc : les
+// états non touchés (clé nulle) restent en tête et ne sont jamais parcourus.
+typedef struct {
+    int *elements;         // États (0-indexés), rangés bloc par bloc
+    int *position;         // Position de chaque état dans elements
+    int *block_of;         // Bloc de chaque état
+    int *start;            // Début de chaque bloc
+    int *end;              // Fin (exclue) de chaque bloc
+    int *block_class;      // Classe persistante de chaque bloc (-1 = transitoire)
+    int *moved;            // États touchés de chaque bloc (rangés en fin)
+    char *in_queue;        // Bloc en attente comme séparateur
+    int *queue;            // Pile des séparateurs en attente
+    int nb_queued;
+    int nb_blocks;
+    double *out_weight;    // P(i, C) accumulé pour le séparateur C
+    double *in_weight;     // somme_{k dans C} P(k, i) accumulé
+    char *touched;
+    int *touched_states;
+    int nb_touched;
+    int *touched_blocks;
+    int nb_touched_blocks;
+} t_refinement;
+
+static void enqueueSplitter(t_refinement *r, int block) {
+    if (r->in_queue[block]) return;
+    r->in_queue[block] = 1;
+    r->queue[r->nb_queued++] = block;
+}
+
+static void touchState(t_refinement *r, int state) {
+    if (r->touched[state]) return;
+    r->touched[state] = 1;
+    r->touched_states[r->nb_touched++] = state;
+
+    int block = r->block_of[state];
+    if (r->moved[block] == 0) {
+        r->touched_blocks[r->nb_touched_blocks++] = block;
+    }
+    int target = r->end[block] - 1 - r->moved[block];
+    int other = r->elements[target];
+    int from = r->position[state];
+    r->elements[target] = state;
+    r->position[state] = target;
+    r->elements[from] = other;
+    r->position[other] = from;
+    r->moved[block]++;
+}
+
+// Découper un bloc touché selon les clés de ses états. Le premier groupe garde
+// l'identifiant du bloc ; si le bloc n'était pas en attente, tous les groupes
+// sauf le plus grand deviennent séparateurs (argument de Paige-Tarjan).
+static void splitBlock(t_refinement *r, int block, t_lump_key *keys, int *bounds) {
+    int first = r->start[block];
+    int last = r->end[block];
+    int nb_moved = r->moved[block];
+    int tail = last - nb_moved;
+    r->moved[block] = 0;
+
+    for (int k = 0; k < nb_moved; k++) {
+        int state = r->elements[tail + k];
+        keys[k].out_key = llround(r->out_weight[state] / LUMP_TOLERANCE);
+        keys[k].in_key = llround(r->in_weight[state] / LUMP_TOLERANCE);
+        keys[k].state = state;
+    }
+    qsort(keys, nb_moved, sizeof(t_lump_key), compareLumpKeys);
+
+    // Bornes des groupes : la tête non touchée a la clé nulle, comme les
+    // états touchés dont les poids s'arrondissent à zéro
+    t_lump_key previous = {0, 0, 0};
+    int nb_groups = 0;
+    if (tail > first) bounds[nb_groups++] = first;
+    for (int k = 0; k < nb_moved; k++) {
+        r->elements[tail + k] = keys[k].state;
+        r->position[keys[k].state] = tail + k;
+        if (nb_groups == 0 || !sameLumpKey(keys[k], previous)) {
+            bounds[nb_groups++] = tail + k;
+        }
+        previous = keys[k];
+    }
+    bounds[nb_groups] = last;
+    if (nb_groups <= 1) return;
+
+    int largest = 0;
+    for (int g = 1; g < nb_groups; g++) {
+        if (bounds[g + 1] - bounds[g] > bounds[largest + 1] - bounds[largest]) largest = g;
+    }
+
+    int was_queued = r->in_queue[block];
+    r->end[block] = bounds[1];
+    for (int g = 0; g < nb_groups; g++) {
+        int id = block;
+        if (g > 0) {
+            id = r->nb_blocks++;
+            r->start[id] = bounds[g];
+            r->end[id] = bounds[g + 1];
+            r->block_class[id] = r->block_class[block];
+            r->in_queue[id] = 0;
+            r->moved[id] = 0;
+            for (int p = bounds[g]; p < bounds[g + 1]; p++) {
+                r->block_of[r->elements[p]] = id;
+            }
+        }
+        if (was_queued || g != largest) {
+            enqueueSplitter(r, id);
+        }
+    }
+}
+
+t_lumping computeLumping(t_adjacency_list adj_list, t_partition partition) {
+    double start_time = getWallTime();
+    int n = adj_list.nb_vertices;
+    int size = n > 0 ? n : 1;
+    const t_reverse_index *index = getReverseIndex(adj_list);
+
+    t_refinement r;
+    memset(&r, 0, sizeof(r));
+    r.elements = (int *)malloc(size * sizeof(int));
+    r.position = (int *)malloc(size * sizeof(int));
+    r.block_of = (int *)malloc(size * sizeof(int));
+    r.start = (int *)malloc(size * sizeof(int));
+    r.end = (int *)malloc(size * sizeof(int));
+    r.block_class = (int *)malloc(size * sizeof(int));
+    r.moved = (int *)calloc(size, sizeof(int));
+    r.in_queue = (char *)calloc(size, sizeof(char));
+    r.queue = (int *)malloc(size * sizeof(int));
+    r.out_weight = (double *)calloc(size, sizeof(double));
+    r.in_weight = (double *)calloc(size, sizeof(double));
+    r.touched = (char *)calloc(size, sizeof(char));
+    r.touched_states = (int *)malloc(size * sizeof(int));
+    r.touched_blocks = (int *)malloc(size * sizeof(int));
+    int *members = (int *)malloc(size * sizeof(int));
+    t_lump_key *keys = (t_lump_key *)malloc(size * sizeof(t_lump_key));
+    int *bounds = (int *)malloc((size + 1) * sizeof(int));
+    int *persistent = (int *)malloc((partition.nb_classes > 0 ? partition.nb_classes : 1) * sizeof(int));
+    if (r.elements == NULL || r.position == NULL || r.block_of == NULL || r.start == NULL ||
+        r.end == NULL || r.block_class == NULL || r.moved == NULL || r.in_queue == NULL ||
+        r.queue == NULL || r.out_weight == NULL || r.in_weight == NULL || r.touched == NULL ||
+        r.touched_states == NULL || r.touched_blocks == NULL || members == NULL || keys == NULL ||
+        bounds == NULL || persistent == NULL) {
+        perror("Failed to allocate memory for lumping");
+        exit(EXIT_FAILURE);
+    }
+
+    // Partition initiale : un bloc pour tous les états transitoires (classe -1),
+    // puis un bloc par classe persistante. Deux classes persistantes ne sont
+    // jamais fusionnées, ni un état transitoire avec un état persistant.
+    int *vertex_to_class = createVertexToClassMap(partition, n);
+    for (int c = 0; c < partition.nb_classes; c++) {
+        persistent[c] = isPersistentClass(adj_list, partition, c, vertex_to_class);
+    }
+    free(vertex_to_class);
+    int filled = 0;
+    for (int pass = 0; pass < 2; pass++) {
+        for (int c = 0; c < partition.nb_classes; c++) {
+            if (persistent[c] != pass) continue;
+            // Passe 0 : toutes les classes transitoires dans le bloc 0
+            if (pass == 1 || r.nb_blocks == 0) {
+                r.start[r.nb_blocks] = filled;
+                r.block_class[r.nb_blocks] = pass == 1 ? c : -1;
+                r.nb_blocks++;
+            }
+            int block = r.nb_blocks - 1;
+            for (int i = 0; i < partition.classes[c].nb_vertices; i++) {
+                int state = partition.classes[c].vertices[i] - 1;
+                r.elements[filled] = state;
+                r.position[state] = filled;
+                r.block_of[state] = block;
+                filled++;
+            }
+            r.end[block] = filled;
+        }
+    }
+    for (int b = r.nb_blocks - 1; b >= 0; b--) {
+        enqueueSplitter(&r, b);
+    }
+
+    int nb_splitters = 0;
+    while (r.nb_queued > 0) {
+        int splitter = r.queue[--r.nb_queued];
+        r.in_queue[splitter] = 0;
+        nb_splitters++;
+
+        // Le séparateur peut lui-même être découpé : copier ses états d'abord
+        int nb_members = r.end[splitter] - r.start[splitter];
+        memcpy(members, &r.elements[r.start[splitter]], nb_members * sizeof(int));
+        int exact = r.block_class[splitter] >= 0;
+
+        for (int m = 0; m < nb_members; m++) {
+            int k = members[m];
+            for (int e = index->offsets[k]; e < index->offsets[k + 1]; e++) {
+                r.out_weight[index->sources[e]] += index->probabilities[e];
+                touchState(&r, index->sources[e]);
+            }
+            // Clé entrante (agrégation exacte) : utile seulement dans les classes
+            // persistantes, dont aucune arête ne sort
+            if (exact) {
+                for (t_cell *current = adj_list.lists[k].head; current != NULL;
+                     current = current->next) {
+                    r.in_weight[current->destination - 1] += current->probability;
+                    touchState(&r, current->destination - 1);
+                }
+            }
+        }
+
+        for (int t = 0; t < r.nb_touched_blocks; t++) {
+            splitBlock(&r, r.touched_blocks[t], keys, bounds);
+        }
+        for (int t = 0; t < r.nb_touched; t++) {
+            int state = r.touched_states[t];
+            r.out_weight[state] = 0.0;
+            r.in_weight[state] = 0.0;
+            r.touched[state] = 0;
+        }
+        r.nb_touched = 0;
+        r.nb_touched_blocks = 0;
+    }
+
+    // Blocs renumérotés dans l'ordre de leur plus petit état
+    t_lumping lumping;
+    lumping.nb_vertices = n;
+    lumping.nb_blocks = r.nb_blocks;
+    lumping.nb_splitters = nb_splitters;
+    lumping.block_of = (int *)malloc(size * sizeof(int));
+    lumping.block_start = (int *)calloc(r.nb_blocks + 1, sizeof(int));
+    lumping.states = (int *)malloc(size * sizeof(int));
+    int *renumber = (int *)malloc((r.nb_blocks > 0 ? r.nb_blocks : 1) * sizeof(int));
+    if (lumping.block_of == NULL || lumping.block_start == NULL || lumping.states == NULL ||
+        renumber == NULL) {
+        perror("Failed to allocate memory for lumping");
+        exit(EXIT_FAILURE);
+    }
+    for (int b = 0; b < r.nb_blocks; b++) {
+        renumber[b] = -1;
+    }
+    int next_block = 0;
+    for (int v = 0; v < n; v++) {
+        int b = r.block_of[v];
+        if (renumber[b] < 0) renumber[b] = next_block++;
+        lumping.block_of[v] = renumber[b];
+        lumping.block_start[renumber[b] + 1]++;
+    }
+    for (int b = 0; b < r.nb_blocks; b++) {
+        lumping.block_start[b + 1] += lumping.block_start[b];
+    }
+    memcpy(r.moved, lumping.block_start, r.nb_blocks * sizeof(int));
+    for (int v = 0; v < n; v++) {
+        lumping.states[r.moved[lumping.block_of[v]]++] = v + 1;
+    }
+    free(renumber);
+
+    free(r.elements);
+    free(r.position);
+    free(r.block_of);
+    free(r.start);
+    free(r.end);
+    free(r.block_class);
+    free(r.moved);
+    free(r.in_queue);
+    free(r.queue);
+    free(r.out_weight);
+    free(r.in_weight);
+    free(r.touched);
+    free(r.touched_states);
+    free(r.touched_blocks);
+    free(members);
+    free(keys);
+    free(bounds);
+    free(persistent);
+
+    lumping.seconds = getWallTime() - start_time;
+    return lumping;
+}
+
+// ============ Chaîne agrégée ============
+
+// La ligne d'un bloc est celle de son premier état : toutes les lignes du bloc
+// donnent la même probabilité vers chaque bloc (agrégation ordinaire)
+t_adjacency_list lumpAdjacencyList(t_adjacency_list adj_list, t_lumping lumping) {
+    int nb_blocks = lumping.nb_blocks;
+    t_adjacency_list lumped = createAdjacencyList(nb_blocks);
+
+    double *weight = (double *)calloc(nb_blocks > 0 ? nb_blocks : 1, sizeof(double));
+    int *targets = (int *)malloc((nb_blocks > 0 ? nb_blocks : 1) * sizeof(int));
+    if (weight == NULL || targets == NULL) {
+        perror("Failed to allocate memory for lumped graph");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int b = 0; b < nb_blocks; b++) {
+        int representative = lumping.states[lumping.block_start[b]] - 1;
+        int nb_targets = 0;
+        for (t_cell *current = adj_list.lists[representative].head; current != NULL;
+             current = current->next) {
+            int target = lumping.block_of[current->destination - 1];
+            if (weight[target] == 0.0) targets[nb_targets++] = target;
+            weight[target] += current->probability;
+        }
+        // addEdge insère en tête : parcourir les blocs atteints à l'envers
+        for (int t = nb_targets - 1; t >= 0; t--) {
+            addEdge(&lumped, b + 1, targets[t] + 1, (float)weight[targets[t]]);
+            weight[targets[t]] = 0.0;
+        }
+    }
+
+    free(weight);
+    free(targets);
+    return lumped;
+}
+
+// ============ Retour aux états d'origine ============
+
+// Classe de la chaîne agrégée contenant chaque classe d'origine. Les classes
+// persistantes se correspondent une à une ; une classe transitoire peut être
+// réunie à d'autres dans une même classe agrégée.
+static int *createLumpedClassMap(t_lumping lumping, t_partition partition,
+                                 t_partition lumped_partition) {
+    int *block_to_class = createVertexToClassMap(lumped_partition, lumping.nb_blocks);
+    int *lumped_class = (int *)malloc((partition.nb_classes > 0 ? partition.nb_classes : 1) * sizeof(int));
+    if (lumped_class == NULL) {
+        perror("Failed to allocate memory for lumped classes");
+        exit(EXIT_FAILURE);
+    }
+    for (int c = 0; c < partition.nb_classes; c++) {
+        lumped_class[c] = block_to_class[lumping.block_of[partition.classes[c].vertices[0] - 1]];
+    }
+    free(block_to_class);
+    return lumped_class;
+}
+
+// Dans un bloc d'une classe persistante, la distribution stationnaire est
+// uniforme (agrégation exacte) : chaque état reçoit Pi(bloc) / taille du bloc
+float **expandLumpedDistributions(t_lumping lumping, t_partition partition,
+                                  t_partition lumped_partition, float **lumped) {
+    int *lumped_class = createLumpedClassMap(lumping, partition, lumped_partition);
+    int *local = (int *)malloc((lumping.nb_blocks > 0 ? lumping.nb_blocks : 1) * sizeof(int));
+    float **distributions = (float **)calloc(partition.nb_classes > 0 ? partition.nb_classes : 1,
+                                             sizeof(float *));
+    if (local == NULL || distributions == NULL) {
+        perror("Failed to allocate memory for lumped distributions");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int c = 0; c < partition.nb_classes; c++) {
+        int l = lumped_class[c];
+        if (lumped[l] == NULL) continue;
+
+        t_class *block_class = &lumped_partition.classes[l];
+        for (int i = 0; i < block_class->nb_vertices; i++) {
+            local[block_class->vertices[i] - 1] = i;
+        }
+
+        t_class *classe = &partition.classes[c];
+        distributions[c] = (float *)malloc(classe->nb_vertices * sizeof(float));
+        if (distributions[c] == NULL) {
+            perror("Failed to allocate memory for lumped distributions");
+            exit(EXIT_FAILURE);
+        }
+        for (int i = 0; i < classe->nb_vertices; i++) {
+            int b = lumping.block_of[classe->vertices[i] - 1];
+            int block_size = lumping.block_start[b + 1] - lumping.block_start[b];
+            distributions[c][i] = lumped[l][local[b]] / (float)block_size;
+        }
+    }
+
+    for (int l = 0; l < lumped_partition.nb_classes; l++) {
+        free(lumped[l]);
+    }
+    free(lumped);
+    free(local);
+    free(lumped_class);
+    return distributions;
+}
+
+// Les lignes et les colonnes sont rangées comme celles de computeAbsorption
+// sur la chaîne d'origine ; chaque état transitoire reprend la ligne de son
+// bloc (agrégation ordinaire)
+t_absorption_result expandLumpedAbsorption(t_lumping lumping, t_partition partition,
+                                           t_partition lumped_partition,
+                                           t_absorption_result lumped) {
+    t_absorption_result result;
+    memset(&result, 0, sizeof(result));
+
+    int nb_classes = partition.nb_classes;
+    int nb_persistent = lumped.nb_persistent;
+    int *lumped_class = createLumpedClassMap(lumping, partition, lumped_partition);
+    int *lumped_column = (int *)malloc((lumped_partition.nb_classes > 0 ? lumped_partition.nb_classes : 1) *
+                                       sizeof(int));
+    int *column = (int *)malloc((nb_persistent > 0 ? nb_persistent : 1) * sizeof(int));
+    int *lumped_row = (int *)malloc((lumping.nb_blocks > 0 ? lumping.nb_blocks : 1) * sizeof(int));
+    result.persistent_classes = (int *)malloc((nb_persistent > 0 ? nb_persistent : 1) * sizeof(int));
+    if (lumped_column == NULL || column == NULL || lumped_row == NULL ||
+        result.persistent_classes == NULL) {
+        perror("Failed to allocate memory for absorption");
+        exit(EXIT_FAILURE);
+    }
+    for (int l = 0; l < lumped_partition.nb_classes; l++) {
+        lumped_column[l] = -1;
+    }
+    for (int k = 0; k < nb_persistent; k++) {
+        lumped_column[lumped.persistent_classes[k]] = k;
+    }
+    for (int row = 0; row < lumped.nb_transient; row++) {
+        lumped_row[lumped.transient_states[row] - 1] = row;
+    }
+
+    // Colonnes : classes persistantes d'origine dans l'ordre de partition
+    for (int c = 0; c < nb_classes; c++) {
+        int k = lumped_column[lumped_class[c]];
+        if (k >= 0) {
+            column[result.nb_persistent] = k;
+            result.persistent_classes[result.nb_persistent++] = c;
+        } else {
+            result.nb_transient += partition.classes[c].nb_vertices;
+        }
+    }
+
+    int rows = result.nb_transient > 0 ? result.nb_transient : 1;
+    result.transient_states = (int *)malloc(rows * sizeof(int));
+    result.probabilities = (double *)malloc((size_t)rows * (nb_persistent > 0 ? nb_persistent : 1) *
+                                            sizeof(double));
+    result.expected_steps = (double *)malloc(rows * sizeof(double));
+    if (result.transient_states == NULL || result.probabilities == NULL ||
+        result.expected_steps == NULL) {
+        perror("Failed to allocate memory for absorption");
+        exit(EXIT_FAILURE);
+    }
+
+    int row = 0;
+    for (int c = 0; c < nb_classes; c++) {
+        if (lumped_column[lumped_class[c]] >= 0) continue;
+        for (int i = 0; i < partition.classes[c].nb_vertices; i++) {
+            int state = partition.classes[c].vertices[i];
+            int source = lumped_row[lumping.block_of[state - 1]];
+            const double *b = &lumped.probabilities[(size_t)source * nb_persistent];
+            result.transient_states[row] = state;
+            for (int k = 0; k < nb_persistent; k++) {
+                result.probabilities[(size_t)row * nb_persistent + k] = b[column[k]];
+            }
+            result.expected_steps[row] = lumped.expected_steps[source];
+            row++;
+        }
+    }
+
+    free(lumped_class);
+    free(lumped_column);
+    free(column);
+    free(lumped_row);
+    return result;
+}
+
+// ============ Affichage ============
+
+void displayLumping(t_lumping lumping, const int *vertex_map) {
+    printf("\n=== Agrégation exacte des états ===\n\n");
+
+    int largest = 0, nb_merged = 0;
+    for (int b = 0; b < lumping.nb_blocks; b++) {
+        int block_size = lumping.block_start[b + 1] - lumping.block_start[b];
+        if (block_size > largest) largest = block_size;
+        if (block_size > 1) nb_merged++;
+    }
+
+    printf("%d états -> %d blocs (réduction x%.1f) en %.3f s, %d séparateurs\n",
+           lumping.nb_vertices, lumping.nb_blocks,
+           lumping.nb_blocks > 0 ? (double)lumping.nb_vertices / lumping.nb_blocks : 1.0,
+           lumping.seconds, lumping.nb_splitters);
+    printf("%d blocs de plusieurs états, le plus grand en compte %d\n", nb_merged, largest);
+
+    // Blocs non triviaux des petites chaînes
+    if (lumping.nb_vertices <= MATRIX_DISPLAY_MAX) {
+        for (int b = 0; b < lumping.nb_blocks; b++) {
+            if (lumping.block_start[b + 1] - lumping.block_start[b] < 2) continue;
+            printf("Bloc %d: {", b + 1);
+            for (int s = lumping.block_start[b]; s < lumping.block_start[b + 1]; s++) {
+                int state = vertex_map != NULL ? vertex_map[lumping.states[s] - 1] + 1
+                                               : lumping.states[s];
+                printf(s == lumping.block_start[b] ? "%d" : ",%d", state);
+            }
+            printf("}\n");
+        }
+    }
+    printf("===================================\n\n");
+}
+
+void freeLumping(t_lumping *lumping) {
+    free(lumping->block_of);
+    free(lumping->block_start);
+    free(lumping->states);
+    lumping->block_of = NULL;
+    lumping->block_start = NULL;
+    lumping->states = NULL;
+}
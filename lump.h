@@ -0,0 +1,48 @@
+#ifndef LUMP_H
+#define LUMP_H
+
+#include "graph.h"
+#include "tarjan.h"
+#include "absorption.h"
+
+// Écart en dessous duquel deux clés de découpe sont considérées égales
+#define LUMP_TOLERANCE 1e-6
+
+// Partition des états en blocs d'états équivalents (agrégation exacte)
+typedef struct {
+    int nb_vertices;       // Nombre d'états de la chaîne d'origine
+    int nb_blocks;         // Nombre de blocs (états de la chaîne agrégée)
+    int *block_of;         // Bloc (0-indexé) de chaque état d'origine
+    int *block_start;      // Début de chaque bloc dans states (nb_blocks + 1)
+    int *states;           // États d'origine (1-indexés), bloc par bloc
+    int nb_splitters;      // Nombre de blocs utilisés comme séparateurs
+    double seconds;        // Durée du raffinement
+} t_lumping;
+
+// Raffinement de partition à la Paige-Tarjan, en partant d'un bloc pour les
+// états transitoires et d'un bloc par classe persistante de partition : un
+// bloc séparateur C découpe chaque bloc selon P(i, C) (clé sortante, par
+// l'index inverse) et, dans les classes persistantes, selon somme_{k dans C}
+// P(k, i) (clé entrante). Les probabilités d'absorption sont alors celles du
+// bloc, et la distribution stationnaire est uniforme dans chaque bloc.
+t_lumping computeLumping(t_adjacency_list adj_list, t_partition partition);
+
+// Chaîne agrégée : un sommet par bloc, numéroté dans l'ordre des blocs
+t_adjacency_list lumpAdjacencyList(t_adjacency_list adj_list, t_lumping lumping);
+
+// Retour aux états d'origine depuis les résultats calculés sur la chaîne
+// agrégée et ses classes (lumped_partition, obtenue par Tarjan) : distributions
+// par classe de partition (voir computeStationaryDistribution, les
+// distributions agrégées sont libérées) et probabilités d'absorption
+float **expandLumpedDistributions(t_lumping lumping, t_partition partition,
+                                  t_partition lumped_partition, float **lumped);
+t_absorption_result expandLumpedAbsorption(t_lumping lumping, t_partition partition,
+                                           t_partition lumped_partition,
+                                           t_absorption_result lumped);
+
+// vertex_map (old_of_new d'une renumérotation, ou NULL) ramène les états
+// affichés aux numéros d'origine
+void displayLumping(t_lumping lumping, const int *vertex_map);
+void freeLumping(t_lumping *lumping);
+
+#endif // LUMP_H
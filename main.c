@@ -2,21 +2,148 @@
 #include "tarjan.h"
 #include "hasse.h"
 #include "matrix.h"
+#include "bitmatrix.h"
+#include "sparse.h"
+#include "simulation.h"
+#include "fit.h"
+#include "online.h"
+#include "absorption.h"
+#include "limit.h"
+#include "lump.h"
+#include "hitting.h"
+#include "query.h"
+#include "spmv.h"
+#include "reorder.h"
 #include "utils.h"
 #include <string.h>
 
 void printUsage() {
     printf("\n=== Programme d'analyse de graphes de Markov ===\n\n");
-    printf("Usage: ./markov <fichier_graphe> [options]\n\n");
+    printf("Usage: ./markov <fichier_graphe> [options]\n");
+    printf("       ./markov --fit <graphe_sortie> <trajectoires> [trajectoires...]\n");
+    printf("       ./markov --online [flux] [--decay=<d>] [--window=<k>]\n\n");
     printf("Options:\n");
     printf("  --partie1     : Afficher le graphe et le vérifier (PARTIE 1)\n");
     printf("  --partie2     : Analyser les composantes connexes (PARTIE 2)\n");
     printf("  --partie3     : Calculer les distributions stationnaires (PARTIE 3)\n");
     printf("  --all         : Exécuter toutes les parties\n");
+    printf("  --stationary=<méthode> : Méthode de calcul des distributions stationnaires\n");
+    printf("                  power (puissances successives, par défaut), direct (LU),\n");
+    printf("                  gmres ou bicgstab (méthodes de Krylov sur matrice creuse),\n");
+    printf("                  gauss-seidel ou sor (balayages en place)\n");
+    printf("  --precond=<p> : Préconditionneur Krylov: none, jacobi, ilu0 (par défaut)\n");
+    printf("  --gmres-restart=<m> : Taille de la base de Krylov pour GMRES(m) (30)\n");
+    printf("  --tolerance=<t> : Résidu relatif visé par les méthodes itératives (1e-6)\n");
+    printf("  --omega=<w>   : Facteur de relaxation de SOR (1.0)\n");
+    printf("  --ordering=<o> : Ordre des balayages Gauss-Seidel/SOR: natural (par défaut), bfs\n");
+    printf("  --acceleration=<a> : Accélération de la méthode des puissances:\n");
+    printf("                  none (par défaut), aitken ou anderson\n");
+    printf("  --anderson-window=<m> : Nombre d'itérés mémorisés par Anderson (5)\n");
+    printf("  --reach=<k>   : Afficher les états accessibles en k pas (PARTIE 3)\n");
+    printf("  --limit-output=<f> : Écrire la matrice limite creuse dans f (PARTIE 3,\n");
+    printf("                  une ligne par état de départ)\n");
+    printf("  --lump        : Agréger les états équivalents avant les calculs par classe\n");
+    printf("                  de la PARTIE 3 (résultats ramenés aux états d'origine)\n");
+    printf("  --drop-tolerance=<t> : Coefficients ignorés dans les puissances creuses (0)\n");
+    printf("  --simulate=<k> : Simuler des marches aléatoires de k pas par marcheur\n");
+    printf("  --walkers=<w> : Nombre de marcheurs indépendants de la simulation (1000)\n");
+    printf("  --seed=<s>    : Graine de la simulation (même graine => mêmes marches) (42)\n");
+    printf("  --start=<i>   : État de départ des marcheurs et des temps d'atteinte\n");
+    printf("                  (par défaut tirage uniforme)\n");
+    printf("  --trajectory=<f> : Écrire les trajectoires simulées dans f (binaire compact)\n");
+    printf("  --sample-stationary : Distributions stationnaires approchées par échantillonnage\n");
+    printf("                  régénératif, avec intervalles de confiance à 95 %%\n");
+    printf("  --rel-error=<e> : Erreur relative visée sur les états les plus lourds (0.01)\n");
+    printf("  --top-k=<k>   : Nombre d'états lourds surveillés pour l'arrêt (10)\n");
+    printf("  --max-steps=<n> : Budget de pas par classe de l'échantillonnage (1e9)\n");
+    printf("  --hitting=<f> : Loi du premier instant d'atteinte des ensembles cibles de f\n");
+    printf("                  (un ensemble d'états par ligne)\n");
+    printf("  --horizon=<k> : Nombre maximal de pas des temps d'atteinte (100)\n");
+    printf("  --hitting-output=<f> : Écrire P(tau = k) pas par pas dans f (sortie standard)\n");
+    printf("  --query=<f>   : Distributions pi0 M^k pour chaque distribution initiale de f\n");
+    printf("                  (une par ligne, entrées état:poids ou état)\n");
+    printf("  --steps=<k,...> : Pas demandés par --query (3,7)\n");
+    printf("  --query-output=<f> : Écrire les distributions complètes dans f\n");
+    printf("  --bench-spmv[=<k>] : Mesurer les noyaux y = x P (k produits par variante, 20)\n");
+    printf("                  et les comparer à la bande passante mémoire\n");
+    printf("  --reorder=<o> : Renuméroter les états avant les calculs: none (par défaut),\n");
+    printf("                  bfs, rcm (Cuthill-McKee inverse) ou scc (classes dans l'ordre\n");
+    printf("                  topologique) ; les résultats restent en numéros d'origine\n");
+    printf("  --bench-reorder[=<k>] : Comparer la localité des renumérotations\n");
+    printf("                  (défauts de cache, k produits SpMV par ordre, 20)\n");
     printf("  --help        : Afficher cette aide\n\n");
     printf("Exemples:\n");
     printf("  ./markov exemple1.txt --all\n");
-    printf("  ./markov exemple_meteo.txt --partie3\n\n");
+    printf("  ./markov exemple_meteo.txt --partie3\n");
+    printf("  ./markov exemple_meteo.txt --partie3 --stationary=direct\n");
+    printf("  ./markov exemple_meteo.txt --simulate=1000000 --walkers=64 --seed=7\n");
+    printf("  ./markov exemple_meteo.txt --hitting=cibles.txt --horizon=50 --start=1\n");
+    printf("  ./markov exemple_meteo.txt --query=initiales.txt --steps=1,10,100\n");
+    printf("  ./markov --fit estime.txt journal1.txt journal2.bin\n\n");
+    printf("Trajectoires (--fit): fichiers texte (une trajectoire par ligne, états séparés\n");
+    printf("par des blancs) ou fichiers binaires écrits par --trajectory.\n\n");
+    printf("Estimation en continu (--online): lit les états sur l'entrée standard ou\n");
+    printf("depuis un FIFO. 'snapshot [fichier]' écrit le graphe estimé sans interrompre\n");
+    printf("la lecture, 'break' termine la trajectoire courante.\n");
+    printf("  --decay=<d>   : Facteur d'oubli exponentiel par observation (1 = aucun)\n");
+    printf("  --window=<k>  : Ne garder que les k dernières transitions (incompatible\n");
+    printf("                  avec --decay)\n\n");
+}
+
+int runFit(const char *output, const char **filenames, int nb_files) {
+    printf("\n========== ESTIMATION ==========\n");
+
+    t_fit_result fit = fitTransitions(filenames, nb_files);
+
+    printf("Transitions lues: %lld en %.3f s", fit.transitions, fit.seconds);
+    if (fit.seconds > 0.0) {
+        printf(" (%.1f millions/s)", fit.transitions / fit.seconds / 1e6);
+    }
+    printf("\n");
+    printf("États: %d, transitions distinctes: %zu\n", fit.nb_vertices, fit.counts.size);
+
+    // Les états jamais quittés n'ont pas de ligne : le graphe n'est alors pas de Markov
+    int *has_exit = (int *)calloc(fit.nb_vertices > 0 ? fit.nb_vertices : 1, sizeof(int));
+    if (has_exit == NULL) {
+        perror("Failed to allocate memory for fit summary");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t i = 0; i < fit.counts.capacity; i++) {
+        if (fit.counts.keys[i] != TRANSITION_EMPTY) {
+            has_exit[fit.counts.keys[i] >> 32] = 1;
+        }
+    }
+    int nb_without_exit = 0;
+    for (int i = 0; i < fit.nb_vertices; i++) {
+        if (!has_exit[i]) nb_without_exit++;
+    }
+    free(has_exit);
+    if (nb_without_exit > 0) {
+        printf("Attention: %d états sans transition sortante observée\n", nb_without_exit);
+    }
+
+    writeTransitionGraph(fit.counts, fit.nb_vertices, output);
+    printf("Graphe estimé écrit dans %s\n", output);
+    printf("========== FIN ESTIMATION ==========\n\n");
+
+    freeFitResult(&fit);
+    return EXIT_SUCCESS;
+}
+
+// Copie de la partition dans une autre numérotation (new_of_old pour le graphe
+// de travail) : mêmes classes et même ordre des sommets dans chaque classe, si
+// bien que les vecteurs rangés par position dans la classe restent valables
+t_partition renumberPartition(t_partition partition, const int *mapping) {
+    t_partition result = createPartition();
+    for (int c = 0; c < partition.nb_classes; c++) {
+        t_class classe = createClass(partition.classes[c].name);
+        for (int i = 0; i < partition.classes[c].nb_vertices; i++) {
+            addVertexToClass(&classe, partition.classes[c].vertices[i]);
+        }
+        renumberVertices(classe.vertices, classe.nb_vertices, mapping);
+        addClassToPartition(&result, classe);
+    }
+    return result;
 }
 
 int main(int argc, char *argv[]) {
@@ -32,14 +159,171 @@ int main(int argc, char *argv[]) {
         return EXIT_SUCCESS;
     }
 
+    // Mode estimation : compter les transitions de journaux de trajectoires
+    if (strcmp(argv[1], "--fit") == 0) {
+        if (argc < 4) {
+            printf("Erreur: --fit attend un fichier de sortie et au moins un fichier de trajectoires\n");
+            printUsage();
+            return EXIT_FAILURE;
+        }
+        return runFit(argv[2], (const char **)&argv[3], argc - 3);
+    }
+
+    // Mode continu : estimer les transitions d'un flux d'observations
+    if (strcmp(argv[1], "--online") == 0) {
+        const char *source = NULL;
+        double decay = 1.0;
+        int window = 0;
+        for (int i = 2; i < argc; i++) {
+            if (strncmp(argv[i], "--decay=", 8) == 0) {
+                decay = atof(argv[i] + 8);
+            } else if (strncmp(argv[i], "--window=", 9) == 0) {
+                window = atoi(argv[i] + 9);
+            } else {
+                source = argv[i];
+            }
+        }
+
+        FILE *input = stdin;
+        if (source != NULL && strcmp(source, "-") != 0) {
+            input = fopen(source, "r");
+            if (input == NULL) {
+                perror("Could not open observation stream");
+                return EXIT_FAILURE;
+            }
+        }
+        runOnlineEstimator(input, decay, window);
+        if (input != stdin) fclose(input);
+        return EXIT_SUCCESS;
+    }
+
     const char *filename = argv[1];
 
     // Déterminer quelles parties exécuter
     int run_partie1 = 0;
     int run_partie2 = 0;
     int run_partie3 = 0;
+    int nb_part_options = 0;
+    int reach_steps = 0;
+    float drop_tolerance = 0.0f;
+    int run_simulation = 0;
+    t_simulation_options simulation_options = defaultSimulationOptions();
+    int run_sampling = 0;
+    t_sampling_options sampling_options = defaultSamplingOptions();
+    const char *hitting_file = NULL;
+    t_hitting_options hitting_options = defaultHittingOptions();
+    const char *query_file = NULL;
+    const char *query_steps = QUERY_DEFAULT_STEPS;
+    const char *query_output = NULL;
+    const char *limit_output = NULL;
+    int lump = 0;
+    int spmv_iterations = 0;
+    t_reordering reordering = REORDER_NONE;
+    int reorder_iterations = 0;
+    t_stationary_options stationary_options = defaultStationaryOptions();
+
+    for (int i = 2; i < argc; i++) {
+        if (strncmp(argv[i], "--stationary=", 13) == 0) {
+            if (!parseStationaryMethod(argv[i] + 13, &stationary_options.method)) {
+                printf("Erreur: méthode stationnaire inconnue '%s'\n", argv[i] + 13);
+                printUsage();
+                return EXIT_FAILURE;
+            }
+        } else if (strncmp(argv[i], "--precond=", 10) == 0) {
+            if (!parsePreconditioner(argv[i] + 10, &stationary_options.preconditioner)) {
+                printf("Erreur: préconditionneur inconnu '%s'\n", argv[i] + 10);
+                printUsage();
+                return EXIT_FAILURE;
+            }
+        } else if (strncmp(argv[i], "--gmres-restart=", 16) == 0) {
+            stationary_options.gmres_restart = atoi(argv[i] + 16);
+        } else if (strncmp(argv[i], "--tolerance=", 12) == 0) {
+            stationary_options.tolerance = (float)atof(argv[i] + 12);
+        } else if (strncmp(argv[i], "--omega=", 8) == 0) {
+            stationary_options.omega = (float)atof(argv[i] + 8);
+        } else if (strncmp(argv[i], "--ordering=", 11) == 0) {
+            if (!parseOrdering(argv[i] + 11, &stationary_options.ordering)) {
+                printf("Erreur: ordre de balayage inconnu '%s'\n", argv[i] + 11);
+                printUsage();
+                return EXIT_FAILURE;
+            }
+        } else if (strncmp(argv[i], "--acceleration=", 15) == 0) {
+            if (!parseAcceleration(argv[i] + 15, &stationary_options.acceleration)) {
+                printf("Erreur: accélération inconnue '%s'\n", argv[i] + 15);
+                printUsage();
+                return EXIT_FAILURE;
+            }
+        } else if (strncmp(argv[i], "--anderson-window=", 18) == 0) {
+            stationary_options.anderson_window = atoi(argv[i] + 18);
+        } else if (strncmp(argv[i], "--reach=", 8) == 0) {
+            reach_steps = atoi(argv[i] + 8);
+        } else if (strncmp(argv[i], "--drop-tolerance=", 17) == 0) {
+            drop_tolerance = (float)atof(argv[i] + 17);
+        } else if (strncmp(argv[i], "--simulate=", 11) == 0) {
+            simulation_options.steps = atoll(argv[i] + 11);
+            run_simulation = 1;
+            nb_part_options++;
+        } else if (strncmp(argv[i], "--walkers=", 10) == 0) {
+            simulation_options.walkers = atoll(argv[i] + 10);
+        } else if (strncmp(argv[i], "--seed=", 7) == 0) {
+            simulation_options.seed = strtoull(argv[i] + 7, NULL, 10);
+            sampling_options.seed = simulation_options.seed;
+        } else if (strncmp(argv[i], "--start=", 8) == 0) {
+            simulation_options.start = atoi(argv[i] + 8);
+            hitting_options.start = simulation_options.start;
+        } else if (strcmp(argv[i], "--sample-stationary") == 0) {
+            run_sampling = 1;
+            nb_part_options++;
+        } else if (strncmp(argv[i], "--rel-error=", 12) == 0) {
+            sampling_options.relative_error = atof(argv[i] + 12);
+        } else if (strncmp(argv[i], "--top-k=", 8) == 0) {
+            sampling_options.top_k = atoi(argv[i] + 8);
+        } else if (strncmp(argv[i], "--max-steps=", 12) == 0) {
+            sampling_options.max_steps = (long long)atof(argv[i] + 12);
+        } else if (strncmp(argv[i], "--trajectory=", 13) == 0) {
+            simulation_options.trajectory_file = argv[i] + 13;
+        } else if (strncmp(argv[i], "--hitting=", 10) == 0) {
+            hitting_file = argv[i] + 10;
+            nb_part_options++;
+        } else if (strncmp(argv[i], "--horizon=", 10) == 0) {
+            hitting_options.horizon = atoi(argv[i] + 10);
+        } else if (strncmp(argv[i], "--hitting-output=", 17) == 0) {
+            hitting_options.output_file = argv[i] + 17;
+        } else if (strncmp(argv[i], "--query=", 8) == 0) {
+            query_file = argv[i] + 8;
+            nb_part_options++;
+        } else if (strncmp(argv[i], "--steps=", 8) == 0) {
+            query_steps = argv[i] + 8;
+        } else if (strncmp(argv[i], "--query-output=", 15) == 0) {
+            query_output = argv[i] + 15;
+        } else if (strcmp(argv[i], "--lump") == 0) {
+            lump = 1;
+        } else if (strncmp(argv[i], "--limit-output=", 15) == 0) {
+            limit_output = argv[i] + 15;
+        } else if (strncmp(argv[i], "--reorder=", 10) == 0) {
+            if (!parseReordering(argv[i] + 10, &reordering)) {
+                printf("Erreur: renumérotation inconnue '%s'\n", argv[i] + 10);
+                printUsage();
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[i], "--bench-reorder") == 0) {
+            reorder_iterations = REORDER_BENCH_DEFAULT_ITERATIONS;
+            nb_part_options++;
+        } else if (strncmp(argv[i], "--bench-reorder=", 16) == 0) {
+            reorder_iterations = atoi(argv[i] + 16);
+            nb_part_options++;
+        } else if (strcmp(argv[i], "--bench-spmv") == 0) {
+            spmv_iterations = SPMV_BENCH_DEFAULT_ITERATIONS;
+            nb_part_options++;
+        } else if (strncmp(argv[i], "--bench-spmv=", 13) == 0) {
+            spmv_iterations = atoi(argv[i] + 13);
+            nb_part_options++;
+        } else {
+            nb_part_options++;
+        }
+    }
 
-    if (argc == 2) {
+    if (nb_part_options == 0) {
         // Par défaut, exécuter toutes les parties
         run_partie1 = run_partie2 = run_partie3 = 1;
     } else {
@@ -68,6 +352,24 @@ int main(int argc, char *argv[]) {
     t_adjacency_list adj_list = readGraph(filename);
     printf("Graphe chargé: %d sommets\n", adj_list.nb_vertices);
 
+    // Graphe de travail des calculs parcourant le graphe ; l'affichage, les
+    // fichiers Mermaid et les résultats restent en numéros d'origine
+    t_adjacency_list work_graph = adj_list;
+    t_permutation permutation;
+    const t_permutation *work_permutation = NULL;
+    if (reordering != REORDER_NONE) {
+        permutation = computeReordering(adj_list, reordering);
+        work_graph = permuteAdjacencyList(adj_list, permutation);
+        work_permutation = &permutation;
+
+        t_ordering_profile before = computeOrderingProfile(adj_list);
+        t_ordering_profile after = computeOrderingProfile(work_graph);
+        printf("Renumérotation %s: largeur de bande %d -> %d, écart moyen %.1f -> %.1f\n",
+               reorderingName(reordering), before.bandwidth, after.bandwidth,
+               before.mean_distance, after.mean_distance);
+    }
+    const int *vertex_map = work_permutation != NULL ? work_permutation->new_of_old : NULL;
+
     if (run_partie1) {
         printf("\n========== PARTIE 1 ==========\n");
 
@@ -97,7 +399,9 @@ int main(int argc, char *argv[]) {
     if (run_partie2 || run_partie3) {
         printf("\n========== PARTIE 2 ==========\n");
 
-        // Appliquer l'algorithme de Tarjan
+        // Appliquer l'algorithme de Tarjan sur le graphe d'origine : l'ordre de
+        // parcours fixe la numérotation des classes et des sommets dans chaque
+        // classe, qui reste ainsi celle d'une exécution sans --reorder
         printf("Application de l'algorithme de Tarjan...\n");
         partition = tarjan(adj_list);
 
@@ -125,74 +429,240 @@ int main(int argc, char *argv[]) {
     if (run_partie3) {
         printf("\n========== PARTIE 3 ==========\n");
 
-        // Créer la matrice de transition
-        t_matrix M = adjacencyListToMatrix(adj_list);
-        printf("Matrice de transition créée\n");
-        displayMatrix(M);
-
-        // Calculer M^3
-        printf("Calcul de M^3:\n");
-        t_matrix M3 = matrixPower(M, 3);
-        displayMatrix(M3);
-        freeMatrix(&M3);
-
-        // Calculer M^7
-        printf("Calcul de M^7:\n");
-        t_matrix M7 = matrixPower(M, 7);
-        displayMatrix(M7);
-        freeMatrix(&M7);
-
-        // Trouver la convergence
-        printf("Recherche de la convergence (epsilon = 0.01)...\n");
-        t_matrix Mn_prev = createEmptyMatrix(M.rows);
-        copyMatrix(Mn_prev, M);
-
-        int n = 1;
-        float diff;
-        do {
-            n++;
-            t_matrix Mn = matrixPower(M, n);
-            diff = matrixDifference(Mn, Mn_prev);
-
-            if (diff < 0.01f) {
-                printf("Convergence atteinte à M^%d (différence = %.6f)\n", n, diff);
-                displayMatrix(Mn);
-            }
+        // Calculer M^3 et M^7 par produits creux (repli dense si M^k se remplit).
+        // Ces puissances ne servent qu'à l'affichage : au-delà, --query donne
+        // pi0 M^k par produits vecteur-matrice sans former M^k.
+        if (adj_list.nb_vertices <= MATRIX_DISPLAY_MAX) {
+            t_matrix M = adjacencyListToMatrix(adj_list);
+            printf("Matrice de transition créée\n");
+            displayMatrix(M);
+            freeMatrix(&M);
+
+            t_csr_matrix M_sparse = adjacencyListToCSR(adj_list);
+
+            printf("Calcul de M^3:\n");
+            t_csr_matrix M3_sparse = csrMatrixPower(M_sparse, 3, drop_tolerance, SPGEMM_DENSITY_CUTOFF);
+            t_matrix M3 = csrToMatrix(M3_sparse);
+            displayMatrix(M3);
+            freeMatrix(&M3);
+            freeCSRMatrix(&M3_sparse);
+
+            printf("Calcul de M^7:\n");
+            t_csr_matrix M7_sparse = csrMatrixPower(M_sparse, 7, drop_tolerance, SPGEMM_DENSITY_CUTOFF);
+            t_matrix M7 = csrToMatrix(M7_sparse);
+            displayMatrix(M7);
+            freeMatrix(&M7);
+            freeCSRMatrix(&M7_sparse);
+
+            freeCSRMatrix(&M_sparse);
+        } else {
+            printf("Matrice de transition: %dx%d (non affichée)\n",
+                   adj_list.nb_vertices, adj_list.nb_vertices);
+            printf("M^3 et M^7 non calculées (plus de %d états) : utiliser --query\n",
+                   MATRIX_DISPLAY_MAX);
+        }
+
+        // Accessibilité en k pas : seule la structure de M^k est nécessaire
+        if (reach_steps > 0) {
+            displayReachability(adj_list, reach_steps);
+        }
 
-            copyMatrix(Mn_prev, Mn);
-            freeMatrix(&Mn);
+        // Les calculs par classe parcourent le graphe de travail, avec la
+        // partition dans sa numérotation ; les classes gardent leurs indices
+        t_partition work_partition = partition;
+        if (work_permutation != NULL) {
+            work_partition = renumberPartition(partition, work_permutation->new_of_old);
+        }
 
-            if (n > 100) {
-                printf("Pas de convergence après 100 itérations\n");
-                break;
+        // Périodes des classes (BONUS) : si une classe persistante est
+        // périodique, les puissances de M oscillent sans converger
+        int *periods = computeClassPeriods(work_graph, work_partition);
+        int *vertex_to_class = createVertexToClassMap(work_partition, work_graph.nb_vertices);
+        int periodic_persistent = 0;
+        for (int i = 0; i < partition.nb_classes; i++) {
+            if (periods[i] > 1 && isPersistentClass(work_graph, work_partition, i, vertex_to_class)) {
+                periodic_persistent = 1;
             }
-        } while (diff >= 0.01f);
+        }
+        free(vertex_to_class);
+        if (periodic_persistent) {
+            printf("Classe persistante périodique détectée: la matrice limite est la "
+                   "moyenne de Cesàro des puissances de M\n");
+        }
 
-        freeMatrix(&Mn_prev);
+        // Agrégation exacte : les calculs par classe portent sur la chaîne des
+        // blocs d'états équivalents, dont Tarjan recalcule les classes
+        t_adjacency_list class_graph = work_graph;
+        t_partition class_partition = work_partition;
+        int *class_periods = periods;
+        t_lumping lumping;
+        if (lump) {
+            lumping = computeLumping(work_graph, work_partition);
+            displayLumping(lumping, work_permutation != NULL ? work_permutation->old_of_new : NULL);
+            class_graph = lumpAdjacencyList(work_graph, lumping);
+            class_partition = tarjan(class_graph);
+            // L'agrégation peut changer la période (un cycle dont les états
+            // sont équivalents devient une boucle)
+            class_periods = computeClassPeriods(class_graph, class_partition);
+            printf("Calculs par classe sur la chaîne agrégée (%d blocs, %d classes), "
+                   "résultats ramenés aux classes d'origine\n",
+                   lumping.nb_blocks, class_partition.nb_classes);
+        }
 
-        // Calculer les distributions stationnaires par classe
-        computeStationaryDistribution(adj_list, partition, 0.01f);
+        // Calculer les distributions stationnaires par classe, conservées pour
+        // la matrice limite (chaque bloc persistant n'est résolu qu'une fois)
+        float **distributions = (float **)malloc((class_partition.nb_classes > 0 ?
+                                                  class_partition.nb_classes : 1) * sizeof(float *));
+        if (distributions == NULL) {
+            perror("Failed to allocate memory for class distributions");
+            exit(EXIT_FAILURE);
+        }
+        // Sur une chaîne agrégée ou renumérotée, les distributions ne sont
+        // affichées qu'une fois rangées par classe d'origine
+        int display_classes = !lump && work_permutation == NULL;
+        computeStationaryDistribution(class_graph, class_partition, class_periods, 0.01f,
+                                      stationary_options, distributions, display_classes);
+
+        // Devenir des états transitoires (matrice fondamentale)
+        t_absorption_result absorption = computeAbsorption(class_graph, class_partition);
+        if (lump) {
+            distributions = expandLumpedDistributions(lumping, work_partition, class_partition,
+                                                      distributions);
+            t_absorption_result expanded = expandLumpedAbsorption(lumping, work_partition,
+                                                                  class_partition, absorption);
+            freeAbsorptionResult(&absorption);
+            absorption = expanded;
+
+            freeAdjacencyList(&class_graph);
+            freePartition(&class_partition);
+            free(class_periods);
+            freeLumping(&lumping);
+        }
+        if (!display_classes) {
+            displayClassDistributions(work_graph, work_partition, distributions);
+        }
+        if (work_permutation != NULL) {
+            // Les vecteurs par classe suivent l'ordre des sommets de chaque
+            // classe ; seuls les numéros des états transitoires sont à ramener
+            renumberVertices(absorption.transient_states, absorption.nb_transient,
+                             work_permutation->old_of_new);
+            freePartition(&work_partition);
+        }
+        displayAbsorptionResult(absorption);
+
+        // Matrice limite assemblée par blocs, sans itérer sur les puissances de M
+        t_limit_result limit = computeLimitMatrix(partition, adj_list.nb_vertices,
+                                                  distributions, absorption);
+        displayLimitResult(limit);
+        if (limit_output != NULL) {
+            writeLimitMatrix(limit, limit_output);
+        }
+        freeLimitResult(&limit);
+        freeAbsorptionResult(&absorption);
+        for (int i = 0; i < partition.nb_classes; i++) {
+            free(distributions[i]);
+        }
+        free(distributions);
 
         // BONUS: Calculer les périodes
         printf("\n=== BONUS: Calcul des périodes ===\n");
         for (int i = 0; i < partition.nb_classes; i++) {
-            t_matrix sub = subMatrix(M, partition, i);
-            int period = getPeriod(sub);
-            printf("Classe C%d: période = %d\n", i + 1, period);
-            freeMatrix(&sub);
+            printf("Classe C%d: période = %d\n", i + 1, periods[i]);
         }
+        free(periods);
         printf("===================================\n\n");
 
-        freeMatrix(&M);
+        displayMatrixPoolStats(defaultMatrixPool());
+        clearMatrixPool(defaultMatrixPool());
 
         printf("\n========== FIN PARTIE 3 ==========\n\n");
     }
 
+    // ========== Simulation de marches aléatoires ==========
+
+    if (run_simulation) {
+        printf("\n========== SIMULATION ==========\n");
+        printf("%lld marcheurs x %lld pas, graine %llu\n", simulation_options.walkers,
+               simulation_options.steps, (unsigned long long)simulation_options.seed);
+
+        t_simulation_result simulation = simulateWalks(adj_list, simulation_options);
+        displaySimulationResult(simulation);
+        freeSimulationResult(&simulation);
+
+        printf("\n========== FIN SIMULATION ==========\n\n");
+    }
+
+    // ========== Distributions stationnaires approchées ==========
+
+    if (run_sampling) {
+        printf("\n========== ÉCHANTILLONNAGE ==========\n");
+
+        // Les classes sont nécessaires ; Tarjan n'a pas tourné si PARTIE 2/3 sont absentes
+        t_partition sampling_partition = (run_partie2 || run_partie3)
+            ? partition : tarjan(adj_list);
+        estimateStationaryBySampling(adj_list, sampling_partition, sampling_options);
+        if (!(run_partie2 || run_partie3)) {
+            freePartition(&sampling_partition);
+        }
+
+        printf("\n========== FIN ÉCHANTILLONNAGE ==========\n\n");
+    }
+
+    // ========== Temps d'atteinte d'ensembles cibles ==========
+
+    if (hitting_file != NULL) {
+        printf("\n========== TEMPS D'ATTEINTE ==========\n");
+
+        t_target_sets target_sets = readTargetSets(hitting_file, adj_list.nb_vertices);
+        t_hitting_result hitting = computeHittingTimes(work_graph, target_sets, hitting_options,
+                                                        vertex_map);
+        displayHittingResult(hitting, target_sets);
+        freeHittingResult(&hitting);
+        freeTargetSets(&target_sets);
+
+        printf("\n========== FIN TEMPS D'ATTEINTE ==========\n\n");
+    }
+
+    // ========== Distributions après k pas ==========
+
+    if (query_file != NULL) {
+        printf("\n========== DISTRIBUTIONS APRÈS K PAS ==========\n");
+
+        int nb_steps;
+        int *steps = parseStepList(query_steps, &nb_steps);
+        t_distribution_set distributions = readDistributions(query_file, adj_list.nb_vertices);
+        runDistributionQueries(work_graph, distributions, steps, nb_steps, query_output, vertex_map);
+        freeDistributionSet(&distributions);
+        free(steps);
+
+        printf("\n========== FIN DISTRIBUTIONS APRÈS K PAS ==========\n\n");
+    }
+
+    // ========== Banc d'essai des produits vecteur-matrice ==========
+
+    if (spmv_iterations > 0) {
+        printf("\n========== BANC D'ESSAI SPMV ==========\n");
+        runSpmvBenchmark(adj_list, spmv_iterations);
+        printf("\n========== FIN BANC D'ESSAI SPMV ==========\n\n");
+    }
+
+    // ========== Banc d'essai des renumérotations ==========
+
+    if (reorder_iterations > 0) {
+        printf("\n========== BANC D'ESSAI RENUMÉROTATIONS ==========\n");
+        runReorderingBenchmark(adj_list, reorder_iterations);
+        printf("\n========== FIN BANC D'ESSAI RENUMÉROTATIONS ==========\n\n");
+    }
+
     // Libérer la mémoire
     if (run_partie2 || run_partie3) {
         freeLinkArray(&links);
         freePartition(&partition);
     }
+    if (work_permutation != NULL) {
+        freeAdjacencyList(&work_graph);
+        freePermutation(&permutation);
+    }
     freeAdjacencyList(&adj_list);
 
     printf("\n========================================\n");
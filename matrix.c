@@ -1,4 +1,7 @@
 #include "matrix.h"
+#include "solver.h"
+#include "kernels.h"
+#include "parallel.h"
 #include <math.h>
 #include <string.h>
 
@@ -9,18 +12,21 @@ t_matrix createMatrix(int n) {
     matrix.rows = n;
     matrix.cols = n;
 
-    matrix.data = (float **)malloc(n * sizeof(float *));
+    matrix.data = (float **)malloc((n > 0 ? n : 1) * sizeof(float *));
     if (matrix.data == NULL) {
         perror("Failed to allocate memory for matrix rows");
         exit(EXIT_FAILURE);
     }
 
-    for (int i = 0; i < n; i++) {
-        matrix.data[i] = (float *)malloc(n * sizeof(float));
-        if (matrix.data[i] == NULL) {
-            perror("Failed to allocate memory for matrix columns");
-            exit(EXIT_FAILURE);
-        }
+    // Un seul bloc contigu pour les coefficients, les lignes pointent dedans
+    float *block = (float *)malloc(((size_t)n * n > 0 ? (size_t)n * n : 1) * sizeof(float));
+    if (block == NULL) {
+        perror("Failed to allocate memory for matrix columns");
+        exit(EXIT_FAILURE);
+    }
+    matrix.data[0] = block;
+    for (int i = 1; i < n; i++) {
+        matrix.data[i] = block + (size_t)i * n;
     }
 
     return matrix;
@@ -30,10 +36,8 @@ t_matrix createEmptyMatrix(int n) {
     t_matrix matrix = createMatrix(n);
 
     // Initialiser à 0
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            matrix.data[i][j] = 0.0f;
-        }
+    if (n > 0) {
+        memset(matrix.data[0], 0, (size_t)n * n * sizeof(float));
     }
 
     return matrix;
@@ -41,16 +45,92 @@ t_matrix createEmptyMatrix(int n) {
 
 void freeMatrix(t_matrix *matrix) {
     if (matrix->data != NULL) {
-        for (int i = 0; i < matrix->rows; i++) {
-            if (matrix->data[i] != NULL) {
-                free(matrix->data[i]);
-            }
-        }
+        free(matrix->data[0]);
         free(matrix->data);
         matrix->data = NULL;
     }
 }
 
+// ============ Réserve de matrices (pool) ============
+
+static t_matrix_pool default_pool = {{{0}}, 0, 0, 0, 0, 0, PTHREAD_MUTEX_INITIALIZER};
+
+static size_t matrixBytes(int n) {
+    return (size_t)n * n * sizeof(float) + (size_t)(n > 0 ? n : 1) * sizeof(float *);
+}
+
+t_matrix_pool *defaultMatrixPool() {
+    return &default_pool;
+}
+
+// Emprunter une matrice n x n (contenu non initialisé)
+t_matrix borrowMatrix(t_matrix_pool *pool, int n) {
+    pthread_mutex_lock(&pool->lock);
+
+    // Chercher une matrice libre de la bonne taille
+    for (int i = 0; i < pool->nb_free; i++) {
+        if (pool->free_matrices[i].rows == n) {
+            t_matrix matrix = pool->free_matrices[i];
+            pool->free_matrices[i] = pool->free_matrices[--pool->nb_free];
+            pool->hits++;
+            pthread_mutex_unlock(&pool->lock);
+            return matrix;
+        }
+    }
+
+    pool->misses++;
+    pool->bytes_held += matrixBytes(n);
+    if (pool->bytes_held > pool->peak_bytes) {
+        pool->peak_bytes = pool->bytes_held;
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    // L'allocation se fait hors du verrou
+    return createMatrix(n);
+}
+
+t_matrix borrowEmptyMatrix(t_matrix_pool *pool, int n) {
+    t_matrix matrix = borrowMatrix(pool, n);
+    if (n > 0) {
+        memset(matrix.data[0], 0, (size_t)n * n * sizeof(float));
+    }
+    return matrix;
+}
+
+// Rendre une matrice empruntée ; au-delà de MATRIX_POOL_SIZE matrices libres,
+// la plus ancienne est libérée
+void returnMatrix(t_matrix_pool *pool, t_matrix *matrix) {
+    if (matrix->data == NULL) return;
+
+    pthread_mutex_lock(&pool->lock);
+    if (pool->nb_free == MATRIX_POOL_SIZE) {
+        pool->bytes_held -= matrixBytes(pool->free_matrices[0].rows);
+        freeMatrix(&pool->free_matrices[0]);
+        pool->free_matrices[0] = pool->free_matrices[--pool->nb_free];
+    }
+    pool->free_matrices[pool->nb_free++] = *matrix;
+    pthread_mutex_unlock(&pool->lock);
+    matrix->data = NULL;
+}
+
+// Libérer toutes les matrices libres de la réserve
+void clearMatrixPool(t_matrix_pool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    for (int i = 0; i < pool->nb_free; i++) {
+        pool->bytes_held -= matrixBytes(pool->free_matrices[i].rows);
+        freeMatrix(&pool->free_matrices[i]);
+    }
+    pool->nb_free = 0;
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void displayMatrixPoolStats(t_matrix_pool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    printf("Réserve de matrices: %ld réutilisations, %ld allocations, pic %.1f Ko\n",
+           pool->hits, pool->misses, pool->peak_bytes / 1024.0);
+    pthread_mutex_unlock(&pool->lock);
+}
+
 void displayMatrix(t_matrix matrix) {
     printf("\nMatrice %dx%d:\n", matrix.rows, matrix.cols);
     for (int i = 0; i < matrix.rows; i++) {
@@ -90,6 +170,11 @@ void copyMatrix(t_matrix dest, t_matrix src) {
         exit(EXIT_FAILURE);
     }
 
+    if (src.rows == src.cols && hasSmallKernel(src.rows)) {
+        copySmall(src.rows, dest.data, src.data);
+        return;
+    }
+
     for (int i = 0; i < src.rows; i++) {
         for (int j = 0; j < src.cols; j++) {
             dest.data[i][j] = src.data[i][j];
@@ -103,6 +188,12 @@ void multiplyMatrices(t_matrix a, t_matrix b, t_matrix result) {
         exit(EXIT_FAILURE);
     }
 
+    // Petites matrices carrées : noyau déroulé de taille fixe
+    if (a.rows == a.cols && b.rows == b.cols && a.rows == b.rows && hasSmallKernel(a.rows)) {
+        multiplySmall(a.rows, a.data, b.data, result.data);
+        return;
+    }
+
     for (int i = 0; i < a.rows; i++) {
         for (int j = 0; j < b.cols; j++) {
             result.data[i][j] = 0.0f;
@@ -119,6 +210,10 @@ float matrixDifference(t_matrix m, t_matrix n) {
         exit(EXIT_FAILURE);
     }
 
+    if (m.rows == m.cols && hasSmallKernel(m.rows)) {
+        return differenceSmall(m.rows, m.data, n.data);
+    }
+
     float diff = 0.0f;
     for (int i = 0; i < m.rows; i++) {
         for (int j = 0; j < m.cols; j++) {
@@ -151,16 +246,25 @@ t_matrix matrixPower(t_matrix matrix, int power) {
     copyMatrix(result, matrix);
 
     // Multiplier power-1 fois
-    t_matrix temp = createEmptyMatrix(matrix.rows);
+    t_matrix temp = borrowMatrix(defaultMatrixPool(), matrix.rows);
     for (int p = 1; p < power; p++) {
         multiplyMatrices(result, matrix, temp);
         copyMatrix(result, temp);
     }
 
-    freeMatrix(&temp);
+    returnMatrix(defaultMatrixPool(), &temp);
     return result;
 }
 
+void makeLazyMatrix(t_matrix matrix) {
+    for (int i = 0; i < matrix.rows; i++) {
+        for (int j = 0; j < matrix.cols; j++) {
+            matrix.data[i][j] *= 0.5f;
+        }
+        matrix.data[i][i] += 0.5f;
+    }
+}
+
 // ============ Extraction de sous-matrice ============
 
 t_matrix subMatrix(t_matrix matrix, t_partition part, int compo_index) {
@@ -185,92 +289,457 @@ t_matrix subMatrix(t_matrix matrix, t_partition part, int compo_index) {
     return sub;
 }
 
-// ============ Calcul de distribution stationnaire ============
-
-void computeStationaryDistribution(t_adjacency_list adj_list, t_partition partition,
-                                  float epsilon) {
-    printf("\n=== Calcul des distributions stationnaires ===\n\n");
+// Construire le bloc n x n d'une classe à partir des listes d'adjacence :
+// seules les arêtes internes sont conservées, renumérotées par vertex_to_local.
+// Coût O(n^2 + arêtes sortantes de la classe), indépendant du nombre total d'états.
+t_matrix classSubMatrix(t_adjacency_list adj_list, t_partition partition, int compo_index,
+                        const int *vertex_to_class, const int *vertex_to_local) {
+    if (compo_index < 0 || compo_index >= partition.nb_classes) {
+        fprintf(stderr, "Error: invalid component index\n");
+        exit(EXIT_FAILURE);
+    }
 
-    // Créer la matrice de transition
-    t_matrix M = adjacencyListToMatrix(adj_list);
+    t_class *classe = &partition.classes[compo_index];
+    int n = classe->nb_vertices;
+    t_matrix sub = createEmptyMatrix(n);
 
-    printf("Matrice de transition M:\n");
-    displayMatrix(M);
+    for (int i = 0; i < n; i++) {
+        t_cell *current = adj_list.lists[classe->vertices[i] - 1].head;
+        while (current != NULL) {
+            int dest = current->destination - 1;
+            if (vertex_to_class[dest] == compo_index) {
+                sub.data[i][vertex_to_local[dest]] = current->probability;
+            }
+            current = current->next;
+        }
+    }
 
-    // Déterminer quelles classes sont persistantes
-    int *vertex_to_class = createVertexToClassMap(partition, adj_list.nb_vertices);
+    return sub;
+}
 
-    // Pour chaque classe persistante
-    for (int c = 0; c < partition.nb_classes; c++) {
-        // Vérifier si la classe est persistante (pas de sommet qui sort)
-        int is_persistent = 1;
-        for (int v = 0; v < partition.classes[c].nb_vertices; v++) {
-            int vertex = partition.classes[c].vertices[v] - 1;
+int isPersistentClass(t_adjacency_list adj_list, t_partition partition, int compo_index,
+                      const int *vertex_to_class) {
+    for (int v = 0; v < partition.classes[compo_index].nb_vertices; v++) {
+        int vertex = partition.classes[compo_index].vertices[v] - 1;
 
-            // Vérifier les successeurs de ce sommet
-            t_cell *current = adj_list.lists[vertex].head;
-            while (current != NULL) {
-                int succ_class = vertex_to_class[current->destination - 1];
-                if (succ_class != c) {
-                    is_persistent = 0;
-                    break;
-                }
-                current = current->next;
+        // Vérifier les successeurs de ce sommet
+        t_cell *current = adj_list.lists[vertex].head;
+        while (current != NULL) {
+            if (vertex_to_class[current->destination - 1] != compo_index) {
+                return 0;
             }
-            if (!is_persistent) break;
+            current = current->next;
         }
+    }
+    return 1;
+}
 
-        if (!is_persistent) {
-            printf("Classe C%d est transitoire - distribution limite nulle\n\n", c + 1);
-            continue;
-        }
+// ============ Calcul de distribution stationnaire ============
 
-        printf("Classe C%d est persistante - calcul de la distribution stationnaire...\n", c + 1);
+t_stationary_options defaultStationaryOptions() {
+    t_stationary_options options;
+    options.method = STATIONARY_POWER;
+    options.preconditioner = PRECOND_ILU0;
+    options.gmres_restart = 30;
+    options.max_iterations = 1000;
+    options.tolerance = 1e-6f;
+    options.omega = 1.0f;
+    options.ordering = ORDERING_NATURAL;
+    options.acceleration = ACCELERATION_NONE;
+    options.anderson_window = 5;
+    return options;
+}
 
-        // Extraire la sous-matrice pour cette classe
-        t_matrix sub = subMatrix(M, partition, c);
+// Convertir un nom de méthode (option --stationary=) en méthode
+// Retourne 1 si le nom est reconnu, 0 sinon
+int parseStationaryMethod(const char *name, t_stationary_method *method) {
+    if (strcmp(name, "power") == 0) {
+        *method = STATIONARY_POWER;
+    } else if (strcmp(name, "direct") == 0) {
+        *method = STATIONARY_DIRECT;
+    } else if (strcmp(name, "gmres") == 0) {
+        *method = STATIONARY_GMRES;
+    } else if (strcmp(name, "bicgstab") == 0) {
+        *method = STATIONARY_BICGSTAB;
+    } else if (strcmp(name, "gauss-seidel") == 0) {
+        *method = STATIONARY_GAUSS_SEIDEL;
+    } else if (strcmp(name, "sor") == 0) {
+        *method = STATIONARY_SOR;
+    } else {
+        return 0;
+    }
+    return 1;
+}
 
-        // Calculer les puissances successives jusqu'à convergence
-        t_matrix prev = createEmptyMatrix(sub.rows);
-        copyMatrix(prev, sub);
+// Convertir un nom de préconditionneur (option --precond=) en préconditionneur
+// Retourne 1 si le nom est reconnu, 0 sinon
+int parsePreconditioner(const char *name, t_preconditioner *preconditioner) {
+    if (strcmp(name, "none") == 0) {
+        *preconditioner = PRECOND_NONE;
+    } else if (strcmp(name, "jacobi") == 0) {
+        *preconditioner = PRECOND_JACOBI;
+    } else if (strcmp(name, "ilu0") == 0) {
+        *preconditioner = PRECOND_ILU0;
+    } else {
+        return 0;
+    }
+    return 1;
+}
+
+// Méthode des puissances : M^n jusqu'à ce que deux puissances successives soient proches
+static t_stationary_result stationaryByPowers(t_matrix sub, float epsilon) {
+    t_stationary_result result = createStationaryResult(sub.rows);
 
-        int power = 1;
+    // Petites classes : toute la boucle tient dans les registres
+    if (hasSmallKernel(sub.rows)) {
         float diff;
+        result.iterations = powersSmall(sub.rows, sub.data, epsilon, 1000,
+                                        result.distribution, &diff);
+        result.difference = diff;
+        result.converged = (diff <= epsilon);
+        result.residual = stationaryResidual(sub, result.distribution);
+        return result;
+    }
+
+    // Calculer les puissances successives jusqu'à convergence :
+    // M^n = M^(n-1) M, les deux tampons sont empruntés à la réserve et échangés
+    t_matrix_pool *pool = defaultMatrixPool();
+    t_matrix prev = borrowMatrix(pool, sub.rows);
+    t_matrix next = borrowMatrix(pool, sub.rows);
+    copyMatrix(prev, sub);
+
+    int power = 1;
+    float diff;
+
+    do {
+        power++;
+        multiplyMatrices(prev, sub, next);
+        diff = matrixDifference(next, prev);
+
+        t_matrix temp = prev;
+        prev = next;
+        next = temp;
+
+        if (power > 1000) {
+            break;
+        }
+    } while (diff > epsilon);
+
+    result.iterations = power;
+    result.difference = diff;
+    result.converged = (diff <= epsilon);
 
-        do {
-            power++;
-            t_matrix next = matrixPower(sub, power);
-            diff = matrixDifference(next, prev);
+    // La distribution stationnaire est la première ligne de M^n
+    for (int j = 0; j < prev.rows; j++) {
+        result.distribution[j] = prev.data[0][j];
+    }
+    result.residual = stationaryResidual(sub, result.distribution);
+
+    returnMatrix(pool, &prev);
+    returnMatrix(pool, &next);
+    return result;
+}
+
+// Convertir un nom d'ordre (option --ordering=) en ordre de balayage
+// Retourne 1 si le nom est reconnu, 0 sinon
+int parseOrdering(const char *name, t_ordering *ordering) {
+    if (strcmp(name, "natural") == 0) {
+        *ordering = ORDERING_NATURAL;
+    } else if (strcmp(name, "bfs") == 0) {
+        *ordering = ORDERING_BFS;
+    } else {
+        return 0;
+    }
+    return 1;
+}
+
+// Convertir un nom d'accélération (option --acceleration=) en accélération
+// Retourne 1 si le nom est reconnu, 0 sinon
+int parseAcceleration(const char *name, t_acceleration *acceleration) {
+    if (strcmp(name, "none") == 0) {
+        *acceleration = ACCELERATION_NONE;
+    } else if (strcmp(name, "aitken") == 0) {
+        *acceleration = ACCELERATION_AITKEN;
+    } else if (strcmp(name, "anderson") == 0) {
+        *acceleration = ACCELERATION_ANDERSON;
+    } else {
+        return 0;
+    }
+    return 1;
+}
 
-            copyMatrix(prev, next);
-            freeMatrix(&next);
+static const char *preconditionerName(t_preconditioner preconditioner) {
+    switch (preconditioner) {
+        case PRECOND_JACOBI: return "Jacobi";
+        case PRECOND_ILU0: return "ILU(0)";
+        default: return "sans préconditionneur";
+    }
+}
 
-            if (power > 1000) {
-                printf("Attention: pas de convergence après 1000 itérations\n");
-                break;
+static void displayStationaryResult(t_stationary_result result, t_stationary_options options) {
+    if (!result.converged) {
+        printf("Attention: pas de convergence après %d itérations\n", result.iterations);
+    }
+
+    switch (options.method) {
+        case STATIONARY_DIRECT:
+            printf("Résolution directe (LU avec pivot partiel par blocs)\n");
+            printf("Distribution stationnaire (solution de Pi(P-I) = 0, somme = 1):\n");
+            break;
+        case STATIONARY_GMRES:
+            printf("Convergence atteinte après %d itérations (différence = %.6f)\n",
+                   result.iterations, result.difference);
+            printf("Distribution stationnaire (GMRES(%d), %s):\n",
+                   options.gmres_restart, preconditionerName(options.preconditioner));
+            break;
+        case STATIONARY_BICGSTAB:
+            printf("Convergence atteinte après %d itérations (différence = %.6f)\n",
+                   result.iterations, result.difference);
+            printf("Distribution stationnaire (BiCGStab, %s):\n",
+                   preconditionerName(options.preconditioner));
+            break;
+        case STATIONARY_GAUSS_SEIDEL:
+        case STATIONARY_SOR:
+            printf("Convergence atteinte après %d itérations (différence = %.6f)\n",
+                   result.iterations, result.difference);
+            if (options.method == STATIONARY_SOR) {
+                printf("Distribution stationnaire (SOR, omega = %.2f, ordre %s):\n",
+                       options.omega, options.ordering == ORDERING_BFS ? "BFS" : "naturel");
+            } else {
+                printf("Distribution stationnaire (Gauss-Seidel, ordre %s):\n",
+                       options.ordering == ORDERING_BFS ? "BFS" : "naturel");
+            }
+            break;
+        default:
+            printf("Convergence atteinte après %d itérations (différence = %.6f)\n",
+                   result.iterations, result.difference);
+            if (options.acceleration == ACCELERATION_NONE) {
+                printf("Distribution stationnaire (première ligne de M^%d):\n", result.iterations);
+            } else {
+                if (options.acceleration == ACCELERATION_ANDERSON) {
+                    printf("Accélération d'Anderson (m = %d): ", options.anderson_window);
+                } else {
+                    printf("Extrapolation d'Aitken: ");
+                }
+                printf("%d extrapolations acceptées, %d rejetées\n",
+                       result.extrapolations, result.rejected);
+                printf("Distribution stationnaire (itération Pi <- Pi M accélérée):\n");
             }
-        } while (diff > epsilon);
+            break;
+    }
 
-        printf("Convergence atteinte après %d itérations (différence = %.6f)\n", power, diff);
-        printf("Distribution stationnaire (première ligne de M^%d):\n", power);
+    printf("  Pi* = (");
+    for (int j = 0; j < result.n; j++) {
+        printf("%.4f", result.distribution[j]);
+        if (j < result.n - 1) printf(", ");
+    }
+    printf(")\n");
+    printf("  Résidu ||Pi(P-I)||_1 = %.3e\n\n", result.residual);
+}
 
-        printf("  Pi* = (");
-        for (int j = 0; j < prev.rows; j++) {
-            printf("%.4f", prev.data[0][j]);
-            if (j < prev.rows - 1) printf(", ");
+// Contexte partagé par les tâches de calcul par classe
+typedef struct {
+    t_adjacency_list adj_list;
+    t_partition partition;
+    const int *vertex_to_class;
+    const int *vertex_to_local;
+    const int *periods;
+    const int *order;      // Classes de la plus grande à la plus petite
+    float epsilon;
+    t_stationary_options options;
+    int *persistent;       // Résultats par classe, affichés ensuite dans l'ordre
+    int *lazy;
+    t_stationary_result *results;
+} t_stationary_context;
+
+static void classStationaryTask(int task_index, void *context) {
+    t_stationary_context *ctx = (t_stationary_context *)context;
+    t_stationary_options options = ctx->options;
+    int c = ctx->order[task_index];
+
+    // Vérifier si la classe est persistante (pas de sommet qui sort)
+    ctx->persistent[c] = isPersistentClass(ctx->adj_list, ctx->partition, c, ctx->vertex_to_class);
+    if (!ctx->persistent[c]) return;
+
+    // Les puissances d'une classe périodique ne convergent pas : la méthode
+    // des puissances travaille alors sur la chaîne paresseuse (P + I) / 2,
+    // qui a la même distribution stationnaire
+    int lazy = (options.method == STATIONARY_POWER && ctx->periods[c] > 1);
+    ctx->lazy[c] = lazy;
+
+    t_stationary_result result;
+    if (options.method != STATIONARY_DIRECT &&
+        (options.method != STATIONARY_POWER || options.acceleration != ACCELERATION_NONE)) {
+        // Les méthodes itératives travaillent sur la sous-matrice creuse
+        t_csr_matrix sparse_sub = classSubMatrixCSR(ctx->adj_list, ctx->partition, c,
+                                                    ctx->vertex_to_class, ctx->vertex_to_local);
+        if (lazy) {
+            t_csr_matrix lazy_sub = lazyChainCSR(sparse_sub);
+            freeCSRMatrix(&sparse_sub);
+            sparse_sub = lazy_sub;
+        }
+        if (options.method == STATIONARY_GAUSS_SEIDEL || options.method == STATIONARY_SOR) {
+            result = solveStationaryGaussSeidel(sparse_sub, options);
+        } else if (options.method == STATIONARY_POWER) {
+            result = solveStationaryAccelerated(sparse_sub, options);
+        } else {
+            result = solveStationaryKrylov(sparse_sub, options);
+        }
+        freeCSRMatrix(&sparse_sub);
+    } else {
+        // Construire le bloc de cette classe depuis le graphe
+        t_matrix sub = classSubMatrix(ctx->adj_list, ctx->partition, c,
+                                      ctx->vertex_to_class, ctx->vertex_to_local);
+
+        if (options.method == STATIONARY_DIRECT) {
+            result = solveStationaryDirect(sub);
+        } else {
+            if (lazy) {
+                makeLazyMatrix(sub);
+            }
+            result = stationaryByPowers(sub, ctx->epsilon);
         }
-        printf(")\n\n");
 
-        freeMatrix(&prev);
         freeMatrix(&sub);
     }
 
+    if (lazy) {
+        // Résidu de la chaîne d'origine : Pi(P - I) = 2 Pi(L - I) avec L = (P + I) / 2
+        result.residual *= 2.0f;
+    }
+
+    ctx->results[c] = result;
+}
+
+void computeStationaryDistribution(t_adjacency_list adj_list, t_partition partition,
+                                  const int *periods, float epsilon,
+                                  t_stationary_options options,
+                                  float **distributions, int display) {
+    printf("\n=== Calcul des distributions stationnaires ===\n\n");
+
+    // La matrice complète n'est construite que pour l'affichage des petites chaînes :
+    // les blocs des classes sont extraits directement du graphe
+    if (display && adj_list.nb_vertices <= MATRIX_DISPLAY_MAX) {
+        t_matrix M = adjacencyListToMatrix(adj_list);
+        printf("Matrice de transition M:\n");
+        displayMatrix(M);
+        freeMatrix(&M);
+    } else if (display) {
+        printf("Matrice de transition M: %dx%d (non affichée)\n\n",
+               adj_list.nb_vertices, adj_list.nb_vertices);
+    }
+
+    int nb_classes = partition.nb_classes;
+    int *vertex_to_class = createVertexToClassMap(partition, adj_list.nb_vertices);
+    int *vertex_to_local = createVertexToLocalIndexMap(partition, adj_list.nb_vertices);
+    int *order = createClassOrderBySize(partition);
+    int *persistent = (int *)calloc(nb_classes > 0 ? nb_classes : 1, sizeof(int));
+    int *lazy = (int *)calloc(nb_classes > 0 ? nb_classes : 1, sizeof(int));
+    t_stationary_result *results = (t_stationary_result *)calloc(nb_classes > 0 ? nb_classes : 1,
+                                                                 sizeof(t_stationary_result));
+    if (persistent == NULL || lazy == NULL || results == NULL) {
+        perror("Failed to allocate memory for class results");
+        exit(EXIT_FAILURE);
+    }
+
+    // Les classes sont indépendantes : calcul en parallèle, les plus grandes
+    // d'abord pour limiter l'attente des dernières tâches
+    t_stationary_context context = {adj_list, partition, vertex_to_class, vertex_to_local,
+                                    periods, order, epsilon, options, persistent, lazy, results};
+    parallelFor(nb_classes, classStationaryTask, &context);
+
+    // Affichage dans l'ordre des classes (sortie reproductible)
+    for (int c = 0; c < nb_classes; c++) {
+        if (distributions != NULL) {
+            distributions[c] = NULL;
+        }
+        if (!persistent[c]) {
+            if (display) {
+                printf("Classe C%d est transitoire - distribution limite nulle\n\n", c + 1);
+            }
+            continue;
+        }
+
+        if (display) {
+            printf("Classe C%d est persistante - calcul de la distribution stationnaire...\n", c + 1);
+            if (lazy[c]) {
+                printf("Classe C%d périodique (période = %d) - utilisation de la chaîne "
+                       "paresseuse (P+I)/2\n", c + 1, periods[c]);
+            }
+            displayStationaryResult(results[c], options);
+        } else if (!results[c].converged) {
+            printf("Attention: classe C%d sans convergence après %d itérations\n",
+                   c + 1, results[c].iterations);
+        }
+
+        if (distributions != NULL) {
+            // La distribution change de propriétaire au lieu d'être libérée
+            distributions[c] = results[c].distribution;
+            results[c].distribution = NULL;
+        }
+        freeStationaryResult(&results[c]);
+    }
+
     free(vertex_to_class);
-    freeMatrix(&M);
+    free(vertex_to_local);
+    free(order);
+    free(persistent);
+    free(lazy);
+    free(results);
 
     printf("==============================================\n\n");
 }
 
+void displayClassDistributions(t_adjacency_list adj_list, t_partition partition,
+                               float **distributions) {
+    printf("\n=== Distributions stationnaires par classe ===\n\n");
+
+    int *vertex_to_local = createVertexToLocalIndexMap(partition, adj_list.nb_vertices);
+    double *flow = (double *)calloc(adj_list.nb_vertices > 0 ? adj_list.nb_vertices : 1,
+                                    sizeof(double));
+    if (flow == NULL) {
+        perror("Failed to allocate memory for distribution residual");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int c = 0; c < partition.nb_classes; c++) {
+        t_class *classe = &partition.classes[c];
+        if (distributions[c] == NULL) {
+            printf("Classe C%d est transitoire - distribution limite nulle\n\n", c + 1);
+            continue;
+        }
+
+        // Résidu sur la chaîne d'origine : (Pi P)_j - Pi_j pour les états j de
+        // la classe (une classe persistante ne laisse pas sortir de masse)
+        for (int i = 0; i < classe->nb_vertices; i++) {
+            t_cell *cell = adj_list.lists[classe->vertices[i] - 1].head;
+            while (cell != NULL) {
+                flow[cell->destination - 1] += distributions[c][i] * (double)cell->probability;
+                cell = cell->next;
+            }
+        }
+        double residual = 0.0;
+        for (int i = 0; i < classe->nb_vertices; i++) {
+            int v = classe->vertices[i] - 1;
+            residual += fabs(flow[v] - distributions[c][vertex_to_local[v]]);
+            flow[v] = 0.0;
+        }
+
+        printf("Classe C%d est persistante\n", c + 1);
+        printf("  Pi* = (");
+        for (int i = 0; i < classe->nb_vertices; i++) {
+            printf("%.4f", distributions[c][i]);
+            if (i < classe->nb_vertices - 1) printf(", ");
+        }
+        printf(")\n");
+        printf("  Résidu ||Pi(P-I)||_1 = %.3e\n\n", residual);
+    }
+
+    free(vertex_to_local);
+    free(flow);
+    printf("==============================================\n\n");
+}
+
 // ============ Calcul de période (BONUS) ============
 
 int gcd(int *vals, int nbvals) {
@@ -289,37 +758,121 @@ int gcd(int *vals, int nbvals) {
     return result;
 }
 
-int getPeriod(t_matrix sub_matrix) {
-    int n = sub_matrix.rows;
-    int *periods = (int *)malloc(n * sizeof(int));
-    int period_count = 0;
+static int gcdPair(int a, int b) {
+    while (b != 0) {
+        int temp = b;
+        b = a % b;
+        a = temp;
+    }
+    return a;
+}
+
+// Contexte partagé par les tâches de calcul de période
+typedef struct {
+    t_adjacency_list adj_list;
+    t_partition partition;
+    const int *vertex_to_class;
+    const int *vertex_to_local;
+    const int *order;      // Classes de la plus grande à la plus petite
+    int *level;            // Niveaux BFS (les classes écrivent sur des sommets disjoints)
+    int *periods;
+} t_period_context;
+
+static void classPeriodTask(int task_index, void *context) {
+    t_period_context *ctx = (t_period_context *)context;
+    int c = ctx->order[task_index];
+    t_class *classe = &ctx->partition.classes[c];
+    int *level = ctx->level;
+
+    // Petite classe : masques de successeurs (indices locaux), BFS par niveaux entiers
+    if (hasSmallKernel(classe->nb_vertices)) {
+        uint32_t succ[SMALL_KERNEL_MAX];
+        for (int k = 0; k < classe->nb_vertices; k++) {
+            succ[k] = 0;
+            t_cell *current = ctx->adj_list.lists[classe->vertices[k] - 1].head;
+            while (current != NULL) {
+                int v = current->destination - 1;
+                if (ctx->vertex_to_class[v] == c) {
+                    succ[k] |= (uint32_t)1 << ctx->vertex_to_local[v];
+                }
+                current = current->next;
+            }
+        }
+        ctx->periods[c] = periodSmall(classe->nb_vertices, succ);
+        return;
+    }
 
-    t_matrix power_matrix = createEmptyMatrix(n);
-    t_matrix result_matrix = createEmptyMatrix(n);
-    copyMatrix(power_matrix, sub_matrix);
+    int *queue = (int *)malloc(classe->nb_vertices * sizeof(int));
+    if (queue == NULL) {
+        perror("Failed to allocate memory for period computation");
+        exit(EXIT_FAILURE);
+    }
 
-    for (int cpt = 1; cpt <= n; cpt++) {
-        int diag_nonzero = 0;
-        for (int i = 0; i < n; i++) {
-            if (power_matrix.data[i][i] > 0.0f) {
-                diag_nonzero = 1;
+    // Niveaux BFS depuis le premier sommet de la classe
+    int head = 0, tail = 0;
+    int root = classe->vertices[0] - 1;
+    level[root] = 0;
+    queue[tail++] = root;
+    while (head < tail) {
+        int u = queue[head++];
+        t_cell *current = ctx->adj_list.lists[u].head;
+        while (current != NULL) {
+            int v = current->destination - 1;
+            if (ctx->vertex_to_class[v] == c && level[v] == -1) {
+                level[v] = level[u] + 1;
+                queue[tail++] = v;
             }
+            current = current->next;
         }
+    }
 
-        if (diag_nonzero) {
-            periods[period_count] = cpt;
-            period_count++;
+    // pgcd des écarts de niveau sur les arêtes internes
+    int period = 0;
+    for (int k = 0; k < classe->nb_vertices; k++) {
+        int u = classe->vertices[k] - 1;
+        t_cell *current = ctx->adj_list.lists[u].head;
+        while (current != NULL) {
+            int v = current->destination - 1;
+            if (ctx->vertex_to_class[v] == c) {
+                period = gcdPair(period, abs(level[u] + 1 - level[v]));
+            }
+            current = current->next;
         }
+    }
+    ctx->periods[c] = period;
 
-        multiplyMatrices(power_matrix, sub_matrix, result_matrix);
-        copyMatrix(power_matrix, result_matrix);
+    free(queue);
+}
+
+// Périodes de toutes les classes en un seul passage O(V + E) sur les listes
+// d'adjacence : un parcours en largeur par classe, limité à ses arêtes internes
+// (sur masques de bits pour les classes d'au plus SMALL_KERNEL_MAX états).
+// Les classes sont indépendantes et traitées en parallèle, les plus grandes d'abord.
+// Une classe réduite à un sommet sans boucle a une période de 0.
+int *computeClassPeriods(t_adjacency_list adj_list, t_partition partition) {
+    int nb_vertices = adj_list.nb_vertices;
+    int *periods = (int *)malloc((partition.nb_classes > 0 ? partition.nb_classes : 1) * sizeof(int));
+    int *level = (int *)malloc(nb_vertices * sizeof(int));
+    if (periods == NULL || level == NULL) {
+        perror("Failed to allocate memory for period computation");
+        exit(EXIT_FAILURE);
     }
 
-    int period = gcd(periods, period_count);
+    int *vertex_to_class = createVertexToClassMap(partition, nb_vertices);
+    int *vertex_to_local = createVertexToLocalIndexMap(partition, nb_vertices);
+    int *order = createClassOrderBySize(partition);
+    for (int i = 0; i < nb_vertices; i++) {
+        level[i] = -1;
+    }
 
-    free(periods);
-    freeMatrix(&power_matrix);
-    freeMatrix(&result_matrix);
+    t_period_context context = {adj_list, partition, vertex_to_class, vertex_to_local, order,
+                                level, periods};
+    parallelFor(partition.nb_classes, classPeriodTask, &context);
+
+    free(vertex_to_class);
+    free(vertex_to_local);
+    free(order);
+    free(level);
 
-    return period;
+    return periods;
 }
@@ -1,6 +1,7 @@
 #ifndef MATRIX_H
 #define MATRIX_H
 
+#include <pthread.h>
 #include "graph.h"
 #include "tarjan.h"
 
@@ -11,12 +12,38 @@ typedef struct {
     int cols;              // Nombre de colonnes
 } t_matrix;
 
+// Taille au-delà de laquelle la matrice de transition complète n'est plus affichée
+#define MATRIX_DISPLAY_MAX 20
+
+// Nombre maximal de matrices libres conservées par la réserve
+#define MATRIX_POOL_SIZE 16
+
+// Réserve de matrices réutilisables (évite les allocations dans les boucles)
+// Partagée entre les threads : tous les accès passent par lock
+typedef struct {
+    t_matrix free_matrices[MATRIX_POOL_SIZE]; // Matrices disponibles
+    int nb_free;           // Nombre de matrices disponibles
+    long hits;             // Emprunts servis par une matrice existante
+    long misses;           // Emprunts ayant nécessité une allocation
+    size_t bytes_held;     // Octets alloués par la réserve (prêtés ou libres)
+    size_t peak_bytes;     // Maximum atteint par bytes_held
+    pthread_mutex_t lock;  // Verrou protégeant la réserve
+} t_matrix_pool;
+
 // Fonctions de base pour les matrices
 t_matrix createMatrix(int n);
 t_matrix createEmptyMatrix(int n);
 void freeMatrix(t_matrix *matrix);
 void displayMatrix(t_matrix matrix);
 
+// Fonctions pour la réserve de matrices
+t_matrix_pool *defaultMatrixPool();
+t_matrix borrowMatrix(t_matrix_pool *pool, int n);
+t_matrix borrowEmptyMatrix(t_matrix_pool *pool, int n);
+void returnMatrix(t_matrix_pool *pool, t_matrix *matrix);
+void clearMatrixPool(t_matrix_pool *pool);
+void displayMatrixPoolStats(t_matrix_pool *pool);
+
 // Création de matrice depuis un graphe
 t_matrix adjacencyListToMatrix(t_adjacency_list adj_list);
 
@@ -28,15 +55,88 @@ float matrixDifference(t_matrix m, t_matrix n);
 // Calcul de puissance de matrice
 t_matrix matrixPower(t_matrix matrix, int power);
 
+// Chaîne paresseuse (P + I) / 2 : même distribution stationnaire, apériodique
+void makeLazyMatrix(t_matrix matrix);
+
 // Extraction de sous-matrice pour une classe
 t_matrix subMatrix(t_matrix matrix, t_partition part, int compo_index);
 
+// Extraction du bloc d'une classe directement depuis le graphe (sans matrice complète)
+t_matrix classSubMatrix(t_adjacency_list adj_list, t_partition partition, int compo_index,
+                        const int *vertex_to_class, const int *vertex_to_local);
+
+// Une classe est persistante si aucune arête ne la quitte
+int isPersistentClass(t_adjacency_list adj_list, t_partition partition, int compo_index,
+                      const int *vertex_to_class);
+
+// Méthodes de calcul de la distribution stationnaire
+typedef enum {
+    STATIONARY_POWER,      // Puissances successives de la sous-matrice
+    STATIONARY_DIRECT,     // Résolution directe par factorisation LU
+    STATIONARY_GMRES,      // GMRES(m) préconditionné sur la sous-matrice creuse
+    STATIONARY_BICGSTAB,   // BiCGStab préconditionné sur la sous-matrice creuse
+    STATIONARY_GAUSS_SEIDEL, // Balayages de Gauss-Seidel en place
+    STATIONARY_SOR         // Sur-relaxation successive (Gauss-Seidel pondéré par omega)
+} t_stationary_method;
+
+// Préconditionneurs des méthodes de Krylov
+typedef enum {
+    PRECOND_NONE,          // Aucun préconditionnement
+    PRECOND_JACOBI,        // Inverse de la diagonale
+    PRECOND_ILU0           // Factorisation LU incomplète sans remplissage
+} t_preconditioner;
+
+// Ordre de parcours des états pour Gauss-Seidel / SOR
+typedef enum {
+    ORDERING_NATURAL,      // Ordre de la classe
+    ORDERING_BFS           // Ordre du parcours en largeur depuis le premier état
+} t_ordering;
+
+// Accélération de la convergence de la méthode des puissances
+typedef enum {
+    ACCELERATION_NONE,     // Puissances successives de la matrice (comportement historique)
+    ACCELERATION_AITKEN,   // Extrapolation Delta^2 d'Aitken sur trois itérés vectoriels
+    ACCELERATION_ANDERSON  // Accélération d'Anderson avec une fenêtre de m itérés
+} t_acceleration;
+
+// Options du calcul de distribution stationnaire
+typedef struct {
+    t_stationary_method method;       // Méthode de résolution
+    t_preconditioner preconditioner;  // Préconditionneur (méthodes de Krylov)
+    int gmres_restart;                // Taille m de la base de Krylov pour GMRES(m)
+    int max_iterations;               // Nombre maximal d'itérations
+    float tolerance;                  // Résidu relatif visé (méthodes itératives)
+    float omega;                      // Facteur de relaxation de SOR
+    t_ordering ordering;              // Ordre des balayages de Gauss-Seidel / SOR
+    t_acceleration acceleration;      // Extrapolation des itérés de la méthode des puissances
+    int anderson_window;              // Taille m de la fenêtre d'Anderson
+} t_stationary_options;
+
 // Calcul de distribution stationnaire
+t_stationary_options defaultStationaryOptions();
+int parseStationaryMethod(const char *name, t_stationary_method *method);
+int parsePreconditioner(const char *name, t_preconditioner *preconditioner);
+int parseOrdering(const char *name, t_ordering *ordering);
+int parseAcceleration(const char *name, t_acceleration *acceleration);
+
+// Si distributions n'est pas NULL (nb_classes pointeurs), la distribution de
+// chaque classe persistante y est conservée, dans l'ordre des sommets de la
+// classe (NULL pour les classes transitoires) ; l'appelant libère chaque entrée.
+// Si display est nul, seuls les avertissements de non-convergence sont affichés
+// (l'appelant affiche alors les distributions, voir displayClassDistributions).
+// periods : périodes des classes de partition (computeClassPeriods).
 void computeStationaryDistribution(t_adjacency_list adj_list, t_partition partition,
-                                  float epsilon);
+                                  const int *periods, float epsilon,
+                                  t_stationary_options options,
+                                  float **distributions, int display);
+
+// Distribution de chaque classe (rangées comme celles de computeStationaryDistribution)
+// avec son résidu ||Pi(P-I)||_1 recalculé sur adj_list
+void displayClassDistributions(t_adjacency_list adj_list, t_partition partition,
+                               float **distributions);
 
 // Calcul de période (BONUS)
 int gcd(int *vals, int nbvals);
-int getPeriod(t_matrix sub_matrix);
+int *computeClassPeriods(t_adjacency_list adj_list, t_partition partition);
 
 #endif // MATRIX_H
@@ -0,0 +1,320 @@
+#include "online.h"
+#include "parallel.h"
+#include <string.h>
+#include <ctype.h>
+
+// ============ Estimateur ============
+
+t_online_estimator *createOnlineEstimator(double decay, int window) {
+    if (decay <= 0.0 || decay > 1.0) {
+        fprintf(stderr, "Error: decay factor must be in (0, 1]\n");
+        exit(EXIT_FAILURE);
+    }
+    if (decay < 1.0 && window > 0) {
+        fprintf(stderr, "Error: --decay and --window cannot be combined\n");
+        exit(EXIT_FAILURE);
+    }
+
+    t_online_estimator *estimator = (t_online_estimator *)calloc(1, sizeof(t_online_estimator));
+    if (estimator == NULL) {
+        perror("Failed to allocate memory for online estimator");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int s = 0; s < ONLINE_STRIPES; s++) {
+        estimator->tables[s] = createTransitionTable(TRANSITION_TABLE_INITIAL / ONLINE_STRIPES);
+        if (decay < 1.0) {
+            enableTransitionEpochs(&estimator->tables[s]);
+        }
+        pthread_mutex_init(&estimator->locks[s], NULL);
+    }
+
+    estimator->decay = decay;
+    estimator->weight = 1.0;
+    estimator->window = window > 0 ? window : 0;
+    if (estimator->window > 0) {
+        estimator->window_from = (int *)malloc(estimator->window * sizeof(int));
+        estimator->window_to = (int *)malloc(estimator->window * sizeof(int));
+        if (estimator->window_from == NULL || estimator->window_to == NULL) {
+            perror("Failed to allocate memory for sliding window");
+            exit(EXIT_FAILURE);
+        }
+    }
+    estimator->previous = -1;
+    atomic_init(&estimator->nb_vertices, 0);
+    atomic_init(&estimator->observations, 0);
+
+    return estimator;
+}
+
+void freeOnlineEstimator(t_online_estimator *estimator) {
+    for (int s = 0; s < ONLINE_STRIPES; s++) {
+        freeTransitionTable(&estimator->tables[s]);
+        pthread_mutex_destroy(&estimator->locks[s]);
+    }
+    free(estimator->window_from);
+    free(estimator->window_to);
+    free(estimator);
+}
+
+static void addStripedTransition(t_online_estimator *estimator, int from, int to, double weight) {
+    int stripe = from % ONLINE_STRIPES;
+    pthread_mutex_lock(&estimator->locks[stripe]);
+    addTransition(&estimator->tables[stripe], from, to, weight);
+    pthread_mutex_unlock(&estimator->locks[stripe]);
+}
+
+static void removeStripedTransition(t_online_estimator *estimator, int from, int to) {
+    int stripe = from % ONLINE_STRIPES;
+    pthread_mutex_lock(&estimator->locks[stripe]);
+    removeTransition(&estimator->tables[stripe], from, to, 1.0);
+    pthread_mutex_unlock(&estimator->locks[stripe]);
+}
+
+// Oubli exponentiel : la transition est ajoutée à l'échelle de l'époque
+// courante, puis ONLINE_SWEEP_SLOTS cases de la même bande sont remises à
+// l'échelle, les comptages négligeables devant une observation étant retirés
+static void addDecayedStripedTransition(t_online_estimator *estimator, int from, int to) {
+    int stripe = from % ONLINE_STRIPES;
+    double factor = 1.0 / ONLINE_RESCALE_LIMIT;
+    pthread_mutex_lock(&estimator->locks[stripe]);
+    t_transition_table *table = &estimator->tables[stripe];
+    addDecayedTransition(table, from, to, estimator->weight, estimator->epoch, factor);
+    estimator->sweep_cursors[stripe] =
+        sweepDecayedTransitions(table, estimator->sweep_cursors[stripe], ONLINE_SWEEP_SLOTS,
+                                estimator->epoch, factor, estimator->weight * ONLINE_EVICT_RATIO);
+    pthread_mutex_unlock(&estimator->locks[stripe]);
+}
+
+void observeState(t_online_estimator *estimator, int state) {
+    // Seul le thread de lecture écrit le compteur ; compté avant la transition,
+    // il est publié avec elle par le verrou de la bande
+    atomic_store_explicit(&estimator->observations,
+                          atomic_load_explicit(&estimator->observations, memory_order_relaxed) + 1,
+                          memory_order_relaxed);
+    if (state + 1 > atomic_load(&estimator->nb_vertices)) {
+        atomic_store(&estimator->nb_vertices, state + 1);
+    }
+
+    int from = estimator->previous;
+    estimator->previous = state;
+    if (from < 0) return;
+
+    if (estimator->window > 0) {
+        // Fenêtre pleine : la plus ancienne transition sort (et sa clé avec
+        // elle si c'était la dernière, la table reste de la taille de la fenêtre)
+        long long slot = estimator->window_next;
+        if (estimator->window_count == estimator->window) {
+            removeStripedTransition(estimator, estimator->window_from[slot],
+                                    estimator->window_to[slot]);
+        } else {
+            estimator->window_count++;
+        }
+        estimator->window_from[slot] = from;
+        estimator->window_to[slot] = state;
+        estimator->window_next = (slot + 1) % estimator->window;
+        addStripedTransition(estimator, from, state, 1.0);
+        return;
+    }
+
+    if (estimator->decay < 1.0) {
+        addDecayedStripedTransition(estimator, from, state);
+        estimator->weight /= estimator->decay;
+        if (estimator->weight > ONLINE_RESCALE_LIMIT) {
+            estimator->weight /= ONLINE_RESCALE_LIMIT;
+            estimator->epoch++;
+        }
+        return;
+    }
+
+    addStripedTransition(estimator, from, state, 1.0);
+}
+
+void breakTrajectory(t_online_estimator *estimator) {
+    estimator->previous = -1;
+}
+
+// ============ Photographies ============
+
+t_transition_table snapshotOnlineCounts(t_online_estimator *estimator, int *nb_vertices,
+                                        long long *observations) {
+    *nb_vertices = atomic_load(&estimator->nb_vertices);
+    t_transition_table snapshot = createTransitionTable(TRANSITION_TABLE_INITIAL);
+
+    for (int s = 0; s < ONLINE_STRIPES; s++) {
+        // Copie brute de la bande sous son verrou, fusion hors verrou
+        pthread_mutex_lock(&estimator->locks[s]);
+        t_transition_table *table = &estimator->tables[s];
+        t_transition_table copy = createTransitionTable(table->capacity);
+        memcpy(copy.keys, table->keys, table->capacity * sizeof(uint64_t));
+        memcpy(copy.counts, table->counts, table->capacity * sizeof(double));
+        copy.size = table->size;
+        if (table->epochs != NULL) {
+            // Comptages ramenés à l'époque la plus récente de la bande (les
+            // lignes, normalisées séparément, n'ont pas besoin d'une échelle commune)
+            unsigned latest = 0;
+            int found = 0;
+            for (size_t i = 0; i < table->capacity; i++) {
+                if (table->keys[i] == TRANSITION_EMPTY) continue;
+                if (!found || (int)(table->epochs[i] - latest) > 0) latest = table->epochs[i];
+                found = 1;
+            }
+            for (size_t i = 0; i < table->capacity; i++) {
+                if (table->keys[i] == TRANSITION_EMPTY) continue;
+                copy.counts[i] = transitionCountAtEpoch(*table, i, latest, 1.0 / ONLINE_RESCALE_LIMIT);
+            }
+        }
+        pthread_mutex_unlock(&estimator->locks[s]);
+
+        mergeTransitionTables(&snapshot, copy);
+        freeTransitionTable(&copy);
+    }
+    if (observations != NULL) {
+        *observations = atomic_load(&estimator->observations);
+    }
+
+    // Un état vu après la lecture de nb_vertices peut apparaître dans une bande copiée ensuite
+    for (size_t i = 0; i < snapshot.capacity; i++) {
+        if (snapshot.keys[i] != TRANSITION_EMPTY) {
+            int from = (int)(snapshot.keys[i] >> 32);
+            int to = (int)(snapshot.keys[i] & 0xFFFFFFFFu);
+            if (from + 1 > *nb_vertices) *nb_vertices = from + 1;
+            if (to + 1 > *nb_vertices) *nb_vertices = to + 1;
+        }
+    }
+
+    return snapshot;
+}
+
+t_adjacency_list snapshotOnlineEstimator(t_online_estimator *estimator) {
+    int nb_vertices;
+    t_transition_table snapshot = snapshotOnlineCounts(estimator, &nb_vertices, NULL);
+    t_adjacency_list adj_list = transitionTableToAdjacencyList(snapshot, nb_vertices);
+    freeTransitionTable(&snapshot);
+    return adj_list;
+}
+
+// ============ Lecture d'un flux ============
+
+// Photographie demandée, écrite par un thread dédié
+typedef struct {
+    t_online_estimator *estimator;
+    char filename[256];
+    long long requested;   // Nombre d'états reçus au moment de la demande
+} t_snapshot_job;
+
+static void *snapshotThread(void *arg) {
+    t_snapshot_job *job = (t_snapshot_job *)arg;
+    double start_time = getWallTime();
+
+    int nb_vertices;
+    long long copied;
+    t_transition_table snapshot = snapshotOnlineCounts(job->estimator, &nb_vertices, &copied);
+    writeTransitionGraph(snapshot, nb_vertices, job->filename);
+    // Les observations reçues pendant la copie n'y figurent qu'en partie
+    fprintf(stderr, "Photographie écrite dans %s (%d états, %zu transitions, "
+            "demandée après %lld observations, copie terminée après %lld, %.3f s)\n",
+            job->filename, nb_vertices, snapshot.size, job->requested, copied,
+            getWallTime() - start_time);
+
+    freeTransitionTable(&snapshot);
+    free(job);
+    return NULL;
+}
+
+// Lire le prochain mot du flux (au plus size-1 caractères) ; *newline indique
+// si le mot termine une ligne, blancs de fin de ligne compris (le mot suivant
+// est alors sur une autre ligne). Retourne 0 en fin de flux.
+static int readWord(FILE *input, char *word, int size, int *newline) {
+    int c;
+    do {
+        c = getc(input);
+        if (c == EOF) return 0;
+    } while (isspace(c));
+
+    int length = 0;
+    while (c != EOF && !isspace(c)) {
+        if (length < size - 1) word[length++] = (char)c;
+        c = getc(input);
+    }
+    word[length] = '\0';
+    while (c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v') {
+        c = getc(input);
+    }
+    *newline = (c == '\n' || c == EOF);
+    if (!*newline) {
+        ungetc(c, input);
+    }
+    return 1;
+}
+
+void runOnlineEstimator(FILE *input, double decay, int window) {
+    t_online_estimator *estimator = createOnlineEstimator(decay, window);
+
+    pthread_t *threads = NULL;
+    int nb_threads = 0, capacity = 0;
+    int nb_snapshots = 0;
+    int pending_snapshot = 0;   // "snapshot" lu, nom de fichier attendu sur la même ligne
+    char word[256];
+    int newline;
+    double start_time = getWallTime();
+
+    while (readWord(input, word, sizeof(word), &newline)) {
+        if (pending_snapshot || strcmp(word, "snapshot") == 0) {
+            t_snapshot_job *job = (t_snapshot_job *)malloc(sizeof(t_snapshot_job));
+            if (job == NULL) {
+                perror("Failed to allocate memory for snapshot");
+                exit(EXIT_FAILURE);
+            }
+            job->estimator = estimator;
+            job->requested = atomic_load(&estimator->observations);
+
+            if (pending_snapshot) {
+                snprintf(job->filename, sizeof(job->filename), "%s", word);
+            } else if (!newline) {
+                // Le nom du fichier suit sur la même ligne
+                pending_snapshot = 1;
+                free(job);
+                continue;
+            } else {
+                snprintf(job->filename, sizeof(job->filename), "snapshot_%d.txt", nb_snapshots + 1);
+            }
+            pending_snapshot = 0;
+            nb_snapshots++;
+
+            if (nb_threads == capacity) {
+                capacity = capacity > 0 ? 2 * capacity : 8;
+                threads = (pthread_t *)realloc(threads, capacity * sizeof(pthread_t));
+                if (threads == NULL) {
+                    perror("Failed to allocate memory for snapshot threads");
+                    exit(EXIT_FAILURE);
+                }
+            }
+            if (pthread_create(&threads[nb_threads], NULL, snapshotThread, job) != 0) {
+                perror("Failed to start snapshot thread");
+                exit(EXIT_FAILURE);
+            }
+            nb_threads++;
+        } else if (strcmp(word, "break") == 0) {
+            breakTrajectory(estimator);
+        } else if (isdigit((unsigned char)word[0])) {
+            int state = atoi(word) - 1;
+            if (state >= 0) {
+                observeState(estimator, state);
+            }
+        } else {
+            fprintf(stderr, "Mot ignoré: '%s'\n", word);
+        }
+    }
+
+    for (int t = 0; t < nb_threads; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    free(threads);
+
+    double seconds = getWallTime() - start_time;
+    printf("Observations: %lld en %.3f s, %d photographies\n",
+           atomic_load(&estimator->observations), seconds, nb_snapshots);
+
+    freeOnlineEstimator(estimator);
+}
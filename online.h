@@ -0,0 +1,74 @@
+#ifndef ONLINE_H
+#define ONLINE_H
+
+#include <stdio.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "graph.h"
+#include "fit.h"
+
+// Nombre de verrous : les états de départ sont répartis entre les bandes
+#define ONLINE_STRIPES 64
+
+// Au-delà de ce poids, une nouvelle époque commence : le poids est multiplié
+// par 1 / ONLINE_RESCALE_LIMIT et chaque comptage le sera quand il sera touché
+#define ONLINE_RESCALE_LIMIT 1e100
+
+// Poids relatif (à une nouvelle observation) en dessous duquel un comptage est oublié
+#define ONLINE_EVICT_RATIO 1e-12
+
+// Cases de la bande remises à l'échelle (et nettoyées) à chaque observation
+#define ONLINE_SWEEP_SLOTS 8
+
+// Estimateur incrémental des transitions.
+// - Oubli exponentiel (decay < 1) : au lieu de multiplier tous les comptages par
+//   decay à chaque observation, le poids des nouvelles observations est divisé par
+//   decay ; la normalisation par ligne rend ce facteur global invisible. Le poids
+//   change d'échelle par époques, chaque clé gardant l'époque de sa dernière mise
+//   à jour ; un curseur par bande parcourt quelques cases par observation et
+//   retire les comptages devenus négligeables (coût O(1) par observation, mémoire
+//   bornée par les transitions encore significatives).
+// - Fenêtre glissante (window > 0) : seules les window dernières transitions comptent,
+//   la plus ancienne est retirée à chaque nouvelle observation. Les deux modes
+//   sont exclusifs.
+// Chaque bande a son verrou : une photographie copie les bandes une par une et
+// ne bloque l'ingestion que sur la bande en cours de copie.
+typedef struct {
+    t_transition_table tables[ONLINE_STRIPES]; // Comptages de la bande (départ % ONLINE_STRIPES)
+    pthread_mutex_t locks[ONLINE_STRIPES];
+    double decay;          // Facteur d'oubli par observation (1 = aucun oubli)
+    double weight;         // Poids de la prochaine transition (à l'échelle de epoch)
+    unsigned epoch;        // Époque courante des poids
+    size_t sweep_cursors[ONLINE_STRIPES]; // Prochaine case à nettoyer de chaque bande
+    int window;            // Taille de la fenêtre (0 = pas de fenêtre)
+    int *window_from;      // Transitions de la fenêtre (anneau)
+    int *window_to;
+    long long window_next; // Prochaine case de l'anneau
+    long long window_count; // Nombre de transitions dans la fenêtre
+    int previous;          // Dernier état observé (0-indexé), -1 en début de trajectoire
+    atomic_int nb_vertices; // Plus grand état observé + 1
+    atomic_llong observations; // Nombre d'états reçus (lu par les photographies)
+} t_online_estimator;
+
+// Fonctions de l'estimateur
+t_online_estimator *createOnlineEstimator(double decay, int window);
+void freeOnlineEstimator(t_online_estimator *estimator);
+void observeState(t_online_estimator *estimator, int state);
+void breakTrajectory(t_online_estimator *estimator);
+
+// Photographie des comptages courants (copie indépendante de l'estimateur).
+// Les bandes sont copiées l'une après l'autre pendant que l'ingestion continue :
+// la photographie n'est pas celle d'un instant précis. Elle contient toutes les
+// observations reçues avant l'appel et aucune au-delà de *observations, nombre
+// d'états reçus à la fin de la copie (si observations n'est pas NULL).
+t_transition_table snapshotOnlineCounts(t_online_estimator *estimator, int *nb_vertices,
+                                        long long *observations);
+t_adjacency_list snapshotOnlineEstimator(t_online_estimator *estimator);
+
+// Lire un flux d'observations (entrée standard ou FIFO) jusqu'à sa fin.
+// Les nombres forment une seule trajectoire (états 1-indexés) ; commandes reconnues :
+//   snapshot [fichier] : écrire le graphe estimé (sans interrompre la lecture)
+//   break              : terminer la trajectoire courante
+void runOnlineEstimator(FILE *input, double decay, int window);
+
+#endif // ONLINE_H
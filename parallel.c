@@ -0,0 +1,175 @@
+#include "parallel.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <time.h>
+#endif
+
+// ============ Nombre de threads ============
+
+static int thread_count = 1;
+static pthread_once_t thread_count_once = PTHREAD_ONCE_INIT;
+
+static void detectThreadCount() {
+    const char *env = getenv("MARKOV_THREADS");
+    if (env != NULL && atoi(env) > 0) {
+        int count = atoi(env);
+        thread_count = count < MAX_THREADS ? count : MAX_THREADS;
+        return;
+    }
+
+    int count = 1;
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    count = (int)info.dwNumberOfProcessors;
+#elif defined(_SC_NPROCESSORS_ONLN)
+    count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+    if (count < 1) count = 1;
+    thread_count = count < MAX_THREADS ? count : MAX_THREADS;
+}
+
+// getenv et sysconf (qui lit /sys) ne sont appelés qu'une fois
+int getThreadCount() {
+    pthread_once(&thread_count_once, detectThreadCount);
+    return thread_count;
+}
+
+// ============ Horloge ============
+
+double getWallTime() {
+#ifdef _WIN32
+    LARGE_INTEGER frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec * 1e-9;
+#endif
+}
+
+// ============ Boucle parallèle ============
+
+typedef struct {
+    t_task_function task;
+    void *context;
+    int nb_tasks;
+    atomic_int next_task;  // Prochaine tâche à distribuer
+} t_parallel_job;
+
+static void runParallelJob(t_parallel_job *job) {
+    int task_index;
+    while ((task_index = atomic_fetch_add(&job->next_task, 1)) < job->nb_tasks) {
+        job->task(task_index, job->context);
+    }
+}
+
+// Pool de threads persistants : chaque travail publié incrémente generation, et
+// seuls les nb_helpers premiers threads y participent avec le thread appelant
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t work_ready;     // Nouveau travail publié
+    pthread_cond_t work_done;      // Dernier assistant terminé
+    int nb_workers;                // Threads du pool (hors thread appelant)
+    unsigned long generation;      // Numéro du dernier travail publié
+    t_parallel_job *job;
+    int nb_helpers;                // Threads du pool affectés au travail courant
+    int pending;                   // Assistants pas encore terminés
+} t_thread_pool;
+
+static t_thread_pool pool = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER,
+                             PTHREAD_COND_INITIALIZER, 0, 0, NULL, 0, 0};
+static pthread_once_t pool_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t pool_busy = PTHREAD_MUTEX_INITIALIZER;  // Un travail à la fois
+static _Thread_local int inside_job = 0;  // Thread en train d'exécuter des tâches
+
+static void *poolWorker(void *arg) {
+    int worker = (int)(intptr_t)arg;
+    unsigned long seen = 0;
+    inside_job = 1;
+
+    for (;;) {
+        pthread_mutex_lock(&pool.lock);
+        while (pool.generation == seen) {
+            pthread_cond_wait(&pool.work_ready, &pool.lock);
+        }
+        seen = pool.generation;
+        t_parallel_job *job = pool.job;
+        int helping = worker < pool.nb_helpers;
+        pthread_mutex_unlock(&pool.lock);
+
+        if (!helping) continue;
+        runParallelJob(job);
+
+        pthread_mutex_lock(&pool.lock);
+        if (--pool.pending == 0) {
+            pthread_cond_signal(&pool.work_done);
+        }
+        pthread_mutex_unlock(&pool.lock);
+    }
+    return NULL;
+}
+
+// Les threads du pool vivent jusqu'à la fin du processus
+static void createThreadPool() {
+    int wanted = getThreadCount() - 1;
+    for (int t = 0; t < wanted; t++) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, poolWorker, (void *)(intptr_t)pool.nb_workers) != 0) {
+            break;
+        }
+        pthread_detach(thread);
+        pool.nb_workers++;
+    }
+}
+
+void parallelFor(int nb_tasks, t_task_function task, void *context) {
+    if (nb_tasks <= 0) return;
+
+    t_parallel_job job;
+    job.task = task;
+    job.context = context;
+    job.nb_tasks = nb_tasks;
+    atomic_init(&job.next_task, 0);
+
+    int nb_helpers = (getThreadCount() < nb_tasks ? getThreadCount() : nb_tasks) - 1;
+    if (nb_helpers <= 0 || inside_job || pthread_mutex_trylock(&pool_busy) != 0) {
+        runParallelJob(&job);
+        return;
+    }
+
+    pthread_once(&pool_once, createThreadPool);
+    if (nb_helpers > pool.nb_workers) nb_helpers = pool.nb_workers;
+
+    pthread_mutex_lock(&pool.lock);
+    pool.job = &job;
+    pool.nb_helpers = nb_helpers;
+    pool.pending = nb_helpers;
+    pool.generation++;
+    pthread_cond_broadcast(&pool.work_ready);
+    pthread_mutex_unlock(&pool.lock);
+
+    // Le thread appelant participe aussi au travail
+    inside_job = 1;
+    runParallelJob(&job);
+    inside_job = 0;
+
+    pthread_mutex_lock(&pool.lock);
+    while (pool.pending > 0) {
+        pthread_cond_wait(&pool.work_done, &pool.lock);
+    }
+    pthread_mutex_unlock(&pool.lock);
+
+    pthread_mutex_unlock(&pool_busy);
+}
@@ -0,0 +1,23 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+// Nombre maximal de threads utilisés par les calculs parallèles
+#define MAX_THREADS 64
+
+// Tâche exécutée par parallelFor pour l'indice task_index
+typedef void (*t_task_function)(int task_index, void *context);
+
+// Nombre de threads à utiliser (variable MARKOV_THREADS, sinon nombre de processeurs),
+// déterminé au premier appel
+int getThreadCount();
+
+// Horloge murale en secondes (pour mesurer les débits)
+double getWallTime();
+
+// Exécuter les tâches 0..nb_tasks-1 sur le pool de threads (créé au premier
+// appel, ses threads attendent ensuite le travail suivant). Chaque thread prend
+// la tâche suivante disponible jusqu'à épuisement. Un appel fait depuis une
+// tâche, ou pendant qu'un autre thread utilise le pool, s'exécute en séquentiel.
+void parallelFor(int nb_tasks, t_task_function task, void *context);
+
+#endif // PARALLEL_H
@@ -0,0 +1,337 @@
+#include "query.h"
+#include "sparse.h"
+#include "parallel.h"
+#include "utils.h"
+#include <ctype.h>
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+
+// Longueur maximale d'une entrée "état:poids" du fichier de distributions
+#define QUERY_TOKEN_MAX 64
+
+// ============ Lecture des distributions ============
+
+static void appendDistribution(t_distribution_set *set, int *states, double *weights,
+                               int size, int *capacity) {
+    if (set->nb_distributions >= *capacity) {
+        *capacity = *capacity > 0 ? 2 * *capacity : 8;
+        set->states = (int **)realloc(set->states, *capacity * sizeof(int *));
+        set->weights = (double **)realloc(set->weights, *capacity * sizeof(double *));
+        set->sizes = (int *)realloc(set->sizes, *capacity * sizeof(int));
+        if (set->states == NULL || set->weights == NULL || set->sizes == NULL) {
+            perror("Failed to reallocate memory for distributions");
+            exit(EXIT_FAILURE);
+        }
+    }
+    set->states[set->nb_distributions] = states;
+    set->weights[set->nb_distributions] = weights;
+    set->sizes[set->nb_distributions] = size;
+    set->nb_distributions++;
+}
+
+t_distribution_set readDistributions(const char *filename, int nb_vertices) {
+    FILE *file = fopen(filename, "r");
+    if (file == NULL) {
+        perror("Could not open distributions file");
+        exit(EXIT_FAILURE);
+    }
+
+    t_distribution_set set;
+    memset(&set, 0, sizeof(set));
+    int set_capacity = 0;
+
+    int *states = NULL;
+    double *weights = NULL;
+    int size = 0;
+    int capacity = 0;
+    char token[QUERY_TOKEN_MAX];
+    int length = 0;
+    int in_comment = 0;
+    int line = 1;
+    int ch;
+    do {
+        ch = fgetc(file);
+        int separator = ch == EOF || ch == '\n' || ch == '#' || ch == ',' || isspace(ch);
+        if (!in_comment && !separator) {
+            if (length >= QUERY_TOKEN_MAX - 1) {
+                fprintf(stderr, "Error: entry too long at line %d of %s\n", line, filename);
+                exit(EXIT_FAILURE);
+            }
+            token[length++] = (char)ch;
+            continue;
+        }
+
+        if (length > 0) {
+            token[length] = '\0';
+            length = 0;
+
+            char *end;
+            long state = strtol(token, &end, 10);
+            double weight = 1.0;
+            if (*end == ':') {
+                weight = strtod(end + 1, &end);
+            }
+            if (*end != '\0' || state < 1 || state > nb_vertices || !(weight >= 0.0)) {
+                fprintf(stderr, "Error: invalid entry '%s' at line %d of %s\n", token, line, filename);
+                exit(EXIT_FAILURE);
+            }
+
+            if (size >= capacity) {
+                capacity = capacity > 0 ? 2 * capacity : 16;
+                states = (int *)realloc(states, capacity * sizeof(int));
+                weights = (double *)realloc(weights, capacity * sizeof(double));
+                if (states == NULL || weights == NULL) {
+                    perror("Failed to reallocate memory for distribution");
+                    exit(EXIT_FAILURE);
+                }
+            }
+            states[size] = (int)state;
+            weights[size] = weight;
+            size++;
+        }
+
+        if (ch == '#') {
+            in_comment = 1;
+        } else if (ch == '\n' || ch == EOF) {
+            if (size > 0) {
+                double total = 0.0;
+                for (int k = 0; k < size; k++) {
+                    total += weights[k];
+                }
+                if (total <= 0.0) {
+                    fprintf(stderr, "Error: distribution with zero total weight at line %d of %s\n",
+                            line, filename);
+                    exit(EXIT_FAILURE);
+                }
+                for (int k = 0; k < size; k++) {
+                    weights[k] /= total;
+                }
+                appendDistribution(&set, states, weights, size, &set_capacity);
+                states = NULL;
+                weights = NULL;
+                size = capacity = 0;
+            }
+            in_comment = 0;
+            line++;
+        }
+    } while (ch != EOF);
+
+    fclose(file);
+    free(states);
+    free(weights);
+
+    if (set.nb_distributions == 0) {
+        fprintf(stderr, "Error: no distribution in %s\n", filename);
+        exit(EXIT_FAILURE);
+    }
+    return set;
+}
+
+void freeDistributionSet(t_distribution_set *set) {
+    for (int d = 0; d < set->nb_distributions; d++) {
+        free(set->states[d]);
+        free(set->weights[d]);
+    }
+    free(set->states);
+    free(set->weights);
+    free(set->sizes);
+    set->states = NULL;
+    set->weights = NULL;
+    set->sizes = NULL;
+    set->nb_distributions = 0;
+}
+
+static int compareSteps(const void *x, const void *y) {
+    int a = *(const int *)x;
+    int b = *(const int *)y;
+    return (a > b) - (a < b);
+}
+
+int *parseStepList(const char *text, int *nb_steps) {
+    int capacity = 1;
+    for (const char *c = text; *c != '\0'; c++) {
+        if (*c == ',') capacity++;
+    }
+    int *steps = (int *)malloc(capacity * sizeof(int));
+    if (steps == NULL) {
+        perror("Failed to allocate memory for step list");
+        exit(EXIT_FAILURE);
+    }
+
+    int count = 0;
+    const char *current = text;
+    while (*current != '\0') {
+        char *end;
+        long value = strtol(current, &end, 10);
+        if (end == current || value < 0 || value > INT_MAX || (*end != ',' && *end != '\0')) {
+            fprintf(stderr, "Error: invalid step list '%s'\n", text);
+            exit(EXIT_FAILURE);
+        }
+        steps[count++] = (int)value;
+        current = *end == ',' ? end + 1 : end;
+    }
+    if (count == 0) {
+        fprintf(stderr, "Error: empty step list\n");
+        exit(EXIT_FAILURE);
+    }
+
+    qsort(steps, count, sizeof(int), compareSteps);
+    int unique = 1;
+    for (int k = 1; k < count; k++) {
+        if (steps[k] != steps[unique - 1]) {
+            steps[unique++] = steps[k];
+        }
+    }
+    *nb_steps = unique;
+    return steps;
+}
+
+// ============ Distributions après k pas ============
+
+// Valeur de l'état d'origine state (0-indexé) dans une colonne du bloc
+static inline double queryValue(const double *block, int width, int column, int state,
+                                const int *vertex_map) {
+    if (vertex_map != NULL) state = vertex_map[state];
+    return block[(size_t)state * width + column];
+}
+
+// Affichage d'une colonne du bloc : vecteur complet pour un petit graphe,
+// sinon les QUERY_DISPLAY_TOP états les plus probables
+static void displayQueryColumn(const double *block, int n, int width, int column,
+                               int distribution, int step, const int *vertex_map) {
+    double total = 0.0;
+    for (int i = 0; i < n; i++) {
+        total += block[(size_t)i * width + column];
+    }
+
+    printf("pi%d M^%d", distribution + 1, step);
+    if (n <= MATRIX_DISPLAY_MAX) {
+        printf(" = [");
+        for (int i = 0; i < n; i++) {
+            printf(i == 0 ? "%.4f" : " %.4f", queryValue(block, width, column, i, vertex_map));
+        }
+        printf("]\n");
+        return;
+    }
+
+    int top_states[QUERY_DISPLAY_TOP];
+    int nb_top = 0;
+    for (int i = 0; i < n; i++) {
+        double value = queryValue(block, width, column, i, vertex_map);
+        if (value <= 0.0) continue;
+        if (nb_top == QUERY_DISPLAY_TOP &&
+            value <= queryValue(block, width, column, top_states[nb_top - 1], vertex_map)) {
+            continue;
+        }
+        int position = nb_top < QUERY_DISPLAY_TOP ? nb_top++ : nb_top - 1;
+        while (position > 0 && queryValue(block, width, column, top_states[position - 1], vertex_map) < value) {
+            top_states[position] = top_states[position - 1];
+            position--;
+        }
+        top_states[position] = i;
+    }
+    printf(" (somme %.6f):", total);
+    for (int t = 0; t < nb_top; t++) {
+        printf(" %d:%.4f", top_states[t] + 1,
+               queryValue(block, width, column, top_states[t], vertex_map));
+    }
+    printf("\n");
+}
+
+static void writeQueryColumn(FILE *output, const double *block, int n, int width, int column,
+                             int distribution, int step, const int *vertex_map) {
+    fprintf(output, "%d %d", distribution + 1, step);
+    for (int i = 0; i < n; i++) {
+        double value = queryValue(block, width, column, i, vertex_map);
+        if (value != 0.0) {
+            fprintf(output, " %d:%.10e", i + 1, value);
+        }
+    }
+    fprintf(output, "\n");
+}
+
+// Les distributions sont regroupées par paquets de SPMM_MAX_VECTORS colonnes ;
+// chaque paquet avance pas à pas jusqu'au plus grand pas demandé et les
+// résultats sont émis dès qu'un pas demandé est atteint.
+void runDistributionQueries(t_adjacency_list adj_list, t_distribution_set set,
+                            const int *steps, int nb_steps, const char *output_file,
+                            const int *vertex_map) {
+    int n = adj_list.nb_vertices;
+    int max_step = steps[nb_steps - 1];
+
+    FILE *output = NULL;
+    if (output_file != NULL) {
+        output = fopen(output_file, "w");
+        if (output == NULL) {
+            perror("Could not open query output file");
+            exit(EXIT_FAILURE);
+        }
+        fprintf(output, "# distribution pas état:probabilité...\n");
+    }
+
+    printf("\n=== Distributions après k pas (%d distributions, pas", set.nb_distributions);
+    for (int s = 0; s < nb_steps; s++) {
+        printf(s == 0 ? " %d" : ",%d", steps[s]);
+    }
+    printf(") ===\n\n");
+
+    double start_time = getWallTime();
+
+    // pi M = (M^T pi^T)^T : le SpMM sur la transposée avance tout le paquet
+    t_csr_matrix transposed = adjacencyListToTransposedCSR(adj_list);
+
+    size_t block_size = (size_t)n * SPMM_MAX_VECTORS;
+    double *current = (double *)malloc((block_size > 0 ? block_size : 1) * sizeof(double));
+    double *next = (double *)malloc((block_size > 0 ? block_size : 1) * sizeof(double));
+    if (current == NULL || next == NULL) {
+        perror("Failed to allocate memory for distribution queries");
+        exit(EXIT_FAILURE);
+    }
+
+    long long nb_products = 0;
+    for (int first = 0; first < set.nb_distributions; first += SPMM_MAX_VECTORS) {
+        int width = min(SPMM_MAX_VECTORS, set.nb_distributions - first);
+        memset(current, 0, (size_t)n * width * sizeof(double));
+        for (int c = 0; c < width; c++) {
+            for (int k = 0; k < set.sizes[first + c]; k++) {
+                int state = set.states[first + c][k] - 1;
+                if (vertex_map != NULL) state = vertex_map[state];
+                current[(size_t)state * width + c] += set.weights[first + c][k];
+            }
+        }
+
+        int next_request = 0;
+        for (int k = 0; k <= max_step; k++) {
+            if (k > 0) {
+                csrMultiplyBlock(transposed, current, next, width);
+                double *swap = current;
+                current = next;
+                next = swap;
+                nb_products++;
+            }
+            if (k != steps[next_request]) continue;
+
+            for (int c = 0; c < width; c++) {
+                displayQueryColumn(current, n, width, c, first + c, k, vertex_map);
+                if (output != NULL) {
+                    writeQueryColumn(output, current, n, width, c, first + c, k, vertex_map);
+                }
+            }
+            next_request++;
+        }
+    }
+
+    double seconds = getWallTime() - start_time;
+    printf("\n%lld produits creux par blocs (%d coefficients) en %.3f s\n",
+           nb_products, transposed.nnz, seconds);
+    if (output != NULL) {
+        printf("Distributions complètes écrites dans %s\n", output_file);
+        fclose(output);
+    }
+    printf("==================================================\n\n");
+
+    free(current);
+    free(next);
+    freeCSRMatrix(&transposed);
+}
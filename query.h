@@ -0,0 +1,39 @@
+#ifndef QUERY_H
+#define QUERY_H
+
+#include "graph.h"
+
+// Pas demandés par défaut (les puissances historiquement affichées en PARTIE 3)
+#define QUERY_DEFAULT_STEPS "3,7"
+
+// Nombre d'états affichés par distribution quand le graphe est trop grand
+#define QUERY_DISPLAY_TOP 5
+
+// Distributions initiales, stockées de façon creuse (une par ligne du fichier)
+typedef struct {
+    int **states;          // États de chaque distribution (1-indexés)
+    double **weights;      // Probabilité de chaque état (normalisées à 1)
+    int *sizes;            // Nombre d'états de chaque distribution
+    int nb_distributions;  // Nombre de distributions
+} t_distribution_set;
+
+// Lecture des distributions : une par ligne, entrées "état:poids" ou "état"
+// (poids 1), séparées par des blancs ou des virgules. Les poids sont normalisés.
+t_distribution_set readDistributions(const char *filename, int nb_vertices);
+void freeDistributionSet(t_distribution_set *set);
+
+// Liste de pas "3,7,20" : triée par ordre croissant, sans doublons
+int *parseStepList(const char *text, int *nb_steps);
+
+// Calcul de pi0 M^k pour chaque distribution et chaque pas demandé, par produits
+// vecteur-matrice creux répétés (O(k_max E) par paquet de SPMM_MAX_VECTORS
+// distributions au lieu de O(k n^3) pour les puissances denses). Les résultats
+// sont affichés au fil du calcul et, si output_file n'est pas NULL, écrits en
+// entier (entrées non nulles) dans ce fichier. vertex_map donne le numéro dans
+// adj_list (0-indexé) de chaque état d'origine quand le graphe a été renuméroté
+// (NULL = même numérotation) ; les résultats restent exprimés en états d'origine.
+void runDistributionQueries(t_adjacency_list adj_list, t_distribution_set set,
+                            const int *steps, int nb_steps, const char *output_file,
+                            const int *vertex_map);
+
+#endif // QUERY_H
@@ -0,0 +1,520 @@
+#include "reorder.h"
+#include "tarjan.h"
+#include "sparse.h"
+#include "spmv.h"
+#include "parallel.h"
+#include "utils.h"
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// ============ Noms des renumérotations ============
+
+// Convertir un nom de renumérotation (option --reorder=)
+// Retourne 1 si le nom est reconnu, 0 sinon
+int parseReordering(const char *name, t_reordering *reordering) {
+    if (strcmp(name, "none") == 0) {
+        *reordering = REORDER_NONE;
+    } else if (strcmp(name, "bfs") == 0) {
+        *reordering = REORDER_BFS;
+    } else if (strcmp(name, "rcm") == 0) {
+        *reordering = REORDER_RCM;
+    } else if (strcmp(name, "scc") == 0) {
+        *reordering = REORDER_SCC;
+    } else {
+        return 0;
+    }
+    return 1;
+}
+
+const char *reorderingName(t_reordering reordering) {
+    switch (reordering) {
+        case REORDER_BFS: return "bfs";
+        case REORDER_RCM: return "rcm";
+        case REORDER_SCC: return "scc";
+        default: return "none";
+    }
+}
+
+// ============ Graphe non orienté ============
+
+// Voisins sans orientation (successeurs puis prédécesseurs) au format CSR :
+// BFS et Cuthill-McKee doivent suivre les arêtes dans les deux sens
+typedef struct {
+    int *offsets;
+    int *neighbors;
+    int n;
+} t_undirected_graph;
+
+static t_undirected_graph buildUndirectedGraph(t_adjacency_list adj_list) {
+    int n = adj_list.nb_vertices;
+    const t_reverse_index *index = getReverseIndex(adj_list);
+
+    t_undirected_graph graph;
+    graph.n = n;
+    graph.offsets = (int *)malloc((n + 1) * sizeof(int));
+    graph.neighbors = (int *)malloc((2 * (size_t)index->nb_edges > 0 ? 2 * (size_t)index->nb_edges : 1) * sizeof(int));
+    if (graph.offsets == NULL || graph.neighbors == NULL) {
+        perror("Failed to allocate memory for undirected graph");
+        exit(EXIT_FAILURE);
+    }
+
+    int pos = 0;
+    for (int i = 0; i < n; i++) {
+        graph.offsets[i] = pos;
+        for (t_cell *current = adj_list.lists[i].head; current != NULL; current = current->next) {
+            graph.neighbors[pos++] = current->destination - 1;
+        }
+        for (int e = index->offsets[i]; e < index->offsets[i + 1]; e++) {
+            graph.neighbors[pos++] = index->sources[e];
+        }
+    }
+    graph.offsets[n] = pos;
+
+    return graph;
+}
+
+static void freeUndirectedGraph(t_undirected_graph *graph) {
+    free(graph->offsets);
+    free(graph->neighbors);
+}
+
+static int degreeOf(const t_undirected_graph *graph, int v) {
+    return graph->offsets[v + 1] - graph->offsets[v];
+}
+
+// ============ Parcours en largeur et Cuthill-McKee ============
+
+// Parcours en largeur depuis start en marquant mark[v] = stamp ; les sommets
+// atteints sont rangés dans queue. Renvoie le nombre de sommets atteints et
+// l'excentricité de start dans *depth.
+static int breadthFirst(const t_undirected_graph *graph, int start, int *mark, int stamp,
+                        int *queue, int *level, int *depth) {
+    int head = 0, tail = 0;
+    mark[start] = stamp;
+    level[start] = 0;
+    queue[tail++] = start;
+    *depth = 0;
+    while (head < tail) {
+        int u = queue[head++];
+        for (int k = graph->offsets[u]; k < graph->offsets[u + 1]; k++) {
+            int v = graph->neighbors[k];
+            if (mark[v] != stamp) {
+                mark[v] = stamp;
+                level[v] = level[u] + 1;
+                if (level[v] > *depth) *depth = level[v];
+                queue[tail++] = v;
+            }
+        }
+    }
+    return tail;
+}
+
+// Sommet pseudo-périphérique (George et Liu) : on repart du sommet de plus
+// faible degré du dernier niveau tant que l'excentricité augmente
+static int pseudoPeripheralVertex(const t_undirected_graph *graph, int start, int *mark,
+                                  int *stamp, int *queue, int *level) {
+    int depth;
+    int count = breadthFirst(graph, start, mark, --(*stamp), queue, level, &depth);
+    for (int attempt = 0; attempt < 5; attempt++) {
+        int candidate = -1;
+        for (int k = count - 1; k >= 0 && level[queue[k]] == depth; k--) {
+            if (candidate < 0 || degreeOf(graph, queue[k]) < degreeOf(graph, candidate)) {
+                candidate = queue[k];
+            }
+        }
+        int candidate_depth;
+        int candidate_count = breadthFirst(graph, candidate, mark, --(*stamp), queue, level,
+                                           &candidate_depth);
+        if (candidate_depth <= depth) break;
+        start = candidate;
+        depth = candidate_depth;
+        count = candidate_count;
+    }
+    return start;
+}
+
+// Les voisins non visités d'un sommet sont ajoutés par degré croissant
+// (les listes sont courtes : tri par insertion)
+static void appendByDegree(const t_undirected_graph *graph, int *order, int first, int last) {
+    for (int k = first + 1; k < last; k++) {
+        int v = order[k];
+        int j = k;
+        while (j > first && (degreeOf(graph, order[j - 1]) > degreeOf(graph, v) ||
+                             (degreeOf(graph, order[j - 1]) == degreeOf(graph, v) && order[j - 1] > v))) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = v;
+    }
+}
+
+// Ordre de parcours en largeur (cuthill_mckee = 0) ou de Cuthill-McKee, une
+// composante connexe après l'autre ; order reçoit le sommet d'origine de chaque rang
+static void breadthFirstOrder(t_adjacency_list adj_list, int cuthill_mckee, int *order) {
+    int n = adj_list.nb_vertices;
+    t_undirected_graph graph = buildUndirectedGraph(adj_list);
+
+    int *visited = (int *)calloc(n > 0 ? n : 1, sizeof(int));
+    int *mark = (int *)malloc((n > 0 ? n : 1) * sizeof(int));
+    int *queue = (int *)malloc((n > 0 ? n : 1) * sizeof(int));
+    int *level = (int *)malloc((n > 0 ? n : 1) * sizeof(int));
+    int *by_degree = (int *)malloc((n > 0 ? n : 1) * sizeof(int));
+    if (visited == NULL || mark == NULL || queue == NULL || level == NULL || by_degree == NULL) {
+        perror("Failed to allocate memory for reordering");
+        exit(EXIT_FAILURE);
+    }
+    for (int v = 0; v < n; v++) {
+        mark[v] = 0;
+    }
+
+    // Sommets par degré croissant (tri par comptage) pour choisir les départs
+    int max_degree = 0;
+    for (int v = 0; v < n; v++) {
+        if (degreeOf(&graph, v) > max_degree) max_degree = degreeOf(&graph, v);
+    }
+    int *bucket = (int *)calloc(max_degree + 2, sizeof(int));
+    if (bucket == NULL) {
+        perror("Failed to allocate memory for reordering");
+        exit(EXIT_FAILURE);
+    }
+    for (int v = 0; v < n; v++) {
+        bucket[degreeOf(&graph, v) + 1]++;
+    }
+    for (int d = 0; d <= max_degree; d++) {
+        bucket[d + 1] += bucket[d];
+    }
+    for (int v = 0; v < n; v++) {
+        by_degree[bucket[degreeOf(&graph, v)]++] = v;
+    }
+    free(bucket);
+
+    int stamp = 0;
+    int nb_ordered = 0;
+    int next_start = 0;
+    while (nb_ordered < n) {
+        int start;
+        if (cuthill_mckee) {
+            while (visited[by_degree[next_start]]) next_start++;
+            start = pseudoPeripheralVertex(&graph, by_degree[next_start], mark, &stamp, queue, level);
+        } else {
+            while (visited[next_start]) next_start++;
+            start = next_start;
+        }
+
+        int head = nb_ordered;
+        visited[start] = 1;
+        order[nb_ordered++] = start;
+        while (head < nb_ordered) {
+            int u = order[head++];
+            int first = nb_ordered;
+            for (int k = graph.offsets[u]; k < graph.offsets[u + 1]; k++) {
+                int v = graph.neighbors[k];
+                if (!visited[v]) {
+                    visited[v] = 1;
+                    order[nb_ordered++] = v;
+                }
+            }
+            if (cuthill_mckee) {
+                appendByDegree(&graph, order, first, nb_ordered);
+            }
+        }
+    }
+
+    free(visited);
+    free(mark);
+    free(queue);
+    free(level);
+    free(by_degree);
+    freeUndirectedGraph(&graph);
+}
+
+// ============ Calcul et application d'une renumérotation ============
+
+t_permutation computeReordering(t_adjacency_list adj_list, t_reordering reordering) {
+    int n = adj_list.nb_vertices;
+    t_permutation permutation;
+    permutation.n = n;
+    permutation.new_of_old = (int *)malloc((n > 0 ? n : 1) * sizeof(int));
+    permutation.old_of_new = (int *)malloc((n > 0 ? n : 1) * sizeof(int));
+    if (permutation.new_of_old == NULL || permutation.old_of_new == NULL) {
+        perror("Failed to allocate memory for permutation");
+        exit(EXIT_FAILURE);
+    }
+
+    int *order = permutation.old_of_new;
+    if (reordering == REORDER_BFS || reordering == REORDER_RCM) {
+        breadthFirstOrder(adj_list, reordering == REORDER_RCM, order);
+        if (reordering == REORDER_RCM) {
+            for (int k = 0; k < n / 2; k++) {
+                int temp = order[k];
+                order[k] = order[n - 1 - k];
+                order[n - 1 - k] = temp;
+            }
+        }
+    } else if (reordering == REORDER_SCC) {
+        // Tarjan produit les classes dans l'ordre topologique inverse : en les
+        // prenant de la dernière à la première, toute arête entre classes va
+        // d'un bloc vers un bloc suivant (P triangulaire supérieure par blocs)
+        t_partition partition = tarjan(adj_list);
+        int pos = 0;
+        for (int c = partition.nb_classes - 1; c >= 0; c--) {
+            for (int k = 0; k < partition.classes[c].nb_vertices; k++) {
+                order[pos++] = partition.classes[c].vertices[k] - 1;
+            }
+        }
+        freePartition(&partition);
+    } else {
+        for (int v = 0; v < n; v++) {
+            order[v] = v;
+        }
+    }
+
+    for (int k = 0; k < n; k++) {
+        permutation.new_of_old[order[k]] = k;
+    }
+    return permutation;
+}
+
+void freePermutation(t_permutation *permutation) {
+    free(permutation->new_of_old);
+    free(permutation->old_of_new);
+    permutation->new_of_old = NULL;
+    permutation->old_of_new = NULL;
+}
+
+// Les cellules sont créées dans l'ordre des nouveaux numéros (meilleure
+// localité des listes) et chaque liste garde l'ordre de la liste d'origine
+t_adjacency_list permuteAdjacencyList(t_adjacency_list adj_list, t_permutation permutation) {
+    int n = adj_list.nb_vertices;
+    t_adjacency_list result = createAdjacencyList(n);
+
+    int capacity = 16;
+    t_cell **cells = (t_cell **)malloc(capacity * sizeof(t_cell *));
+    if (cells == NULL) {
+        perror("Failed to allocate memory for graph permutation");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int v = 0; v < n; v++) {
+        int old = permutation.old_of_new[v];
+        int count = 0;
+        for (t_cell *current = adj_list.lists[old].head; current != NULL; current = current->next) {
+            if (count >= capacity) {
+                capacity *= 2;
+                cells = (t_cell **)realloc(cells, capacity * sizeof(t_cell *));
+                if (cells == NULL) {
+                    perror("Failed to reallocate memory for graph permutation");
+                    exit(EXIT_FAILURE);
+                }
+            }
+            cells[count++] = current;
+        }
+        // addEdge insère en tête : parcourir la liste à l'envers
+        for (int k = count - 1; k >= 0; k--) {
+            addEdge(&result, v + 1, permutation.new_of_old[cells[k]->destination - 1] + 1,
+                    cells[k]->probability);
+        }
+    }
+
+    free(cells);
+    return result;
+}
+
+t_ordering_profile computeOrderingProfile(t_adjacency_list adj_list) {
+    t_ordering_profile profile;
+    profile.bandwidth = 0;
+    profile.mean_distance = 0.0;
+
+    long long nb_edges = 0;
+    double total = 0.0;
+    for (int i = 0; i < adj_list.nb_vertices; i++) {
+        for (t_cell *current = adj_list.lists[i].head; current != NULL; current = current->next) {
+            int distance = abs(current->destination - 1 - i);
+            if (distance > profile.bandwidth) profile.bandwidth = distance;
+            total += distance;
+            nb_edges++;
+        }
+    }
+    if (nb_edges > 0) {
+        profile.mean_distance = total / nb_edges;
+    }
+    return profile;
+}
+
+void renumberVertices(int *vertices, int nb_vertices, const int *mapping) {
+    for (int k = 0; k < nb_vertices; k++) {
+        vertices[k] = mapping[vertices[k] - 1] + 1;
+    }
+}
+
+// ============ Banc d'essai ============
+
+// Défauts d'un cache associatif LRU sur les lectures x[col] du SpMV pull
+static long long simulateCacheMisses(const int *indices, int count, size_t element_size) {
+    int nb_sets = REORDER_CACHE_BYTES / (REORDER_CACHE_LINE * REORDER_CACHE_WAYS);
+    uint64_t *tags = (uint64_t *)malloc((size_t)nb_sets * REORDER_CACHE_WAYS * sizeof(uint64_t));
+    uint64_t *stamps = (uint64_t *)calloc((size_t)nb_sets * REORDER_CACHE_WAYS, sizeof(uint64_t));
+    if (tags == NULL || stamps == NULL) {
+        perror("Failed to allocate memory for cache model");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t k = 0; k < (size_t)nb_sets * REORDER_CACHE_WAYS; k++) {
+        tags[k] = UINT64_MAX;
+    }
+
+    long long misses = 0;
+    uint64_t clock = 0;
+    for (int k = 0; k < count; k++) {
+        uint64_t line = (uint64_t)indices[k] * element_size / REORDER_CACHE_LINE;
+        uint64_t *set_tags = &tags[(line % nb_sets) * REORDER_CACHE_WAYS];
+        uint64_t *set_stamps = &stamps[(line % nb_sets) * REORDER_CACHE_WAYS];
+        clock++;
+
+        int victim = 0;
+        int hit = 0;
+        for (int w = 0; w < REORDER_CACHE_WAYS; w++) {
+            if (set_tags[w] == line) {
+                set_stamps[w] = clock;
+                hit = 1;
+                break;
+            }
+            if (set_stamps[w] < set_stamps[victim]) victim = w;
+        }
+        if (!hit) {
+            set_tags[victim] = line;
+            set_stamps[victim] = clock;
+            misses++;
+        }
+    }
+
+    free(tags);
+    free(stamps);
+    return misses;
+}
+
+// Compteur matériel de défauts de cache (threads créés ensuite compris) ;
+// -1 si le système ne l'expose pas (machine virtuelle, droits insuffisants...)
+static int openCacheMissCounter() {
+#if defined(__linux__)
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+    return -1;
+#endif
+}
+
+static void startCounter(int counter) {
+#if defined(__linux__)
+    if (counter >= 0) {
+        ioctl(counter, PERF_EVENT_IOC_RESET, 0);
+        ioctl(counter, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+static long long stopCounter(int counter) {
+    long long value = -1;
+#if defined(__linux__)
+    if (counter >= 0) {
+        ioctl(counter, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(counter, &value, sizeof(value)) != sizeof(value)) {
+            value = -1;
+        }
+    }
+#endif
+    return value;
+}
+
+static void closeCounter(int counter) {
+#if defined(__linux__)
+    if (counter >= 0) {
+        close(counter);
+    }
+#endif
+}
+
+void runReorderingBenchmark(t_adjacency_list adj_list, int iterations) {
+    int n = adj_list.nb_vertices;
+    if (iterations < 1) iterations = 1;
+
+    printf("\n=== Renumérotations : localité des accès (%d états, %d threads) ===\n", n,
+           getThreadCount());
+    printf("Défauts simulés: lectures de x du SpMV pull, cache LRU %d Ko, %d voies, lignes de %d o\n\n",
+           REORDER_CACHE_BYTES / 1024, REORDER_CACHE_WAYS, REORDER_CACHE_LINE);
+    printf("Ordre   calcul (s)   largeur   écart moyen   défauts simulés   défauts matériels"
+           "   SpMV ms   Tarjan ms\n");
+
+    double *x = (double *)malloc((n > 0 ? n : 1) * sizeof(double));
+    double *y = (double *)malloc((n > 0 ? n : 1) * sizeof(double));
+    if (x == NULL || y == NULL) {
+        perror("Failed to allocate memory for reordering benchmark");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < n; i++) {
+        x[i] = 1.0 / n;
+    }
+
+    int counter = openCacheMissCounter();
+    t_reordering orderings[] = {REORDER_NONE, REORDER_BFS, REORDER_RCM, REORDER_SCC};
+    for (int r = 0; r < 4; r++) {
+        // Le graphe est recopié pour chaque ordre, identité comprise, afin que
+        // toutes les variantes partent de cellules allouées dans leur ordre
+        double start = getWallTime();
+        t_permutation permutation = computeReordering(adj_list, orderings[r]);
+        double reorder_seconds = getWallTime() - start;
+        t_adjacency_list permuted = permuteAdjacencyList(adj_list, permutation);
+
+        t_ordering_profile profile = computeOrderingProfile(permuted);
+        t_csr_matrix transposed = adjacencyListToTransposedCSR(permuted);
+        long long simulated = simulateCacheMisses(transposed.col_idx, transposed.nnz, sizeof(double));
+
+        spmvPull(transposed, x, y);
+        startCounter(counter);
+        start = getWallTime();
+        for (int it = 0; it < iterations; it++) {
+            spmvPull(transposed, x, y);
+        }
+        double spmv_seconds = (getWallTime() - start) / iterations;
+        long long hardware = stopCounter(counter);
+
+        start = getWallTime();
+        t_partition partition = tarjan(permuted);
+        double tarjan_seconds = getWallTime() - start;
+        freePartition(&partition);
+
+        printf("%-6s %11.3f %9d %13.1f %17lld ", reorderingName(orderings[r]), reorder_seconds,
+               profile.bandwidth, profile.mean_distance, simulated);
+        if (hardware >= 0) {
+            printf("%19lld", hardware / iterations);
+        } else {
+            printf("%19s", "n/d");
+        }
+        printf(" %9.3f %11.3f\n", spmv_seconds * 1e3, tarjan_seconds * 1e3);
+
+        freeCSRMatrix(&transposed);
+        freeAdjacencyList(&permuted);
+        freePermutation(&permutation);
+    }
+    closeCounter(counter);
+
+    printf("\nDéfauts matériels: par produit SpMV (n/d si les compteurs ne sont pas accessibles)\n");
+    printf("======================================================================\n\n");
+
+    free(x);
+    free(y);
+}
@@ -0,0 +1,52 @@
+#ifndef REORDER_H
+#define REORDER_H
+
+#include "graph.h"
+
+// Cache simulé par le banc d'essai : taille, associativité et taille de ligne
+#define REORDER_CACHE_BYTES (256 * 1024)
+#define REORDER_CACHE_WAYS 8
+#define REORDER_CACHE_LINE 64
+
+// Nombre de produits SpMV par ordre dans le banc d'essai
+#define REORDER_BENCH_DEFAULT_ITERATIONS 20
+
+// Renumérotations des états
+typedef enum {
+    REORDER_NONE,          // Numérotation du fichier
+    REORDER_BFS,           // Parcours en largeur du graphe non orienté
+    REORDER_RCM,           // Cuthill-McKee inverse (largeur de bande réduite)
+    REORDER_SCC            // Classes regroupées dans l'ordre topologique
+} t_reordering;
+
+// Permutation des sommets (indices 0-indexés dans les deux sens)
+typedef struct {
+    int *new_of_old;       // Nouveau numéro de chaque sommet d'origine
+    int *old_of_new;       // Sommet d'origine de chaque nouveau numéro
+    int n;                 // Nombre de sommets
+} t_permutation;
+
+// Profil de la numérotation : distance |i - j| entre les extrémités des arêtes
+typedef struct {
+    int bandwidth;         // Distance maximale
+    double mean_distance;  // Distance moyenne
+} t_ordering_profile;
+
+int parseReordering(const char *name, t_reordering *reordering);
+const char *reorderingName(t_reordering reordering);
+
+// Calcul et application d'une renumérotation
+t_permutation computeReordering(t_adjacency_list adj_list, t_reordering reordering);
+void freePermutation(t_permutation *permutation);
+t_adjacency_list permuteAdjacencyList(t_adjacency_list adj_list, t_permutation permutation);
+t_ordering_profile computeOrderingProfile(t_adjacency_list adj_list);
+
+// Retour aux numéros d'origine : chaque identifiant (1-indexé) v devient
+// mapping[v - 1] + 1 (old_of_new pour revenir au fichier, new_of_old pour l'inverse)
+void renumberVertices(int *vertices, int nb_vertices, const int *mapping);
+
+// Banc d'essai : pour chaque renumérotation, profil, défauts de cache (simulés,
+// et matériels quand le système les expose) et durées du SpMV et de Tarjan
+void runReorderingBenchmark(t_adjacency_list adj_list, int iterations);
+
+#endif // REORDER_H
@@ -0,0 +1,679 @@
+#include "simulation.h"
+#include "parallel.h"
+#include "trajectory.h"
+#include "matrix.h"
+#include <math.h>
+#include <string.h>
+
+// ============ Tables d'alias ============
+
+// Construction de Vose pour chaque état : les k arêtes sortantes deviennent k cases
+// de masse 1/k, chacune partagée entre au plus deux destinations
+t_alias_table createAliasTable(t_adjacency_list adj_list) {
+    t_alias_table table;
+    int n = adj_list.nb_vertices;
+    table.nb_vertices = n;
+
+    table.offset = (int *)malloc((n + 1) * sizeof(int));
+    if (table.offset == NULL) {
+        perror("Failed to allocate memory for alias table");
+        exit(EXIT_FAILURE);
+    }
+
+    int max_degree = 0;
+    table.offset[0] = 0;
+    for (int i = 0; i < n; i++) {
+        int degree = 0;
+        t_cell *current = adj_list.lists[i].head;
+        while (current != NULL) {
+            degree++;
+            current = current->next;
+        }
+        table.offset[i + 1] = table.offset[i] + degree;
+        if (degree > max_degree) max_degree = degree;
+    }
+
+    int nb_buckets = table.offset[n];
+    table.threshold = (uint32_t *)malloc((nb_buckets > 0 ? nb_buckets : 1) * sizeof(uint32_t));
+    table.destination = (int *)malloc((nb_buckets > 0 ? nb_buckets : 1) * sizeof(int));
+    table.alias = (int *)malloc((nb_buckets > 0 ? nb_buckets : 1) * sizeof(int));
+    double *scaled = (double *)malloc((max_degree > 0 ? max_degree : 1) * sizeof(double));
+    int *small = (int *)malloc((max_degree > 0 ? max_degree : 1) * sizeof(int));
+    int *large = (int *)malloc((max_degree > 0 ? max_degree : 1) * sizeof(int));
+    if (table.threshold == NULL || table.destination == NULL || table.alias == NULL ||
+        scaled == NULL || small == NULL || large == NULL) {
+        perror("Failed to allocate memory for alias table");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < n; i++) {
+        int first = table.offset[i];
+        int k = table.offset[i + 1] - first;
+        if (k == 0) continue;
+
+        // Probabilités normalisées par la somme de la ligne, multipliées par k
+        double sum = 0.0;
+        t_cell *current = adj_list.lists[i].head;
+        for (int b = 0; b < k; b++) {
+            table.destination[first + b] = current->destination - 1;
+            scaled[b] = current->probability;
+            sum += current->probability;
+            current = current->next;
+        }
+
+        int nb_small = 0, nb_large = 0;
+        for (int b = 0; b < k; b++) {
+            scaled[b] = (sum > 0.0) ? scaled[b] * k / sum : 1.0;
+            if (scaled[b] < 1.0) {
+                small[nb_small++] = b;
+            } else {
+                large[nb_large++] = b;
+            }
+        }
+
+        // Chaque case trop légère est complétée par une case trop lourde
+        while (nb_small > 0 && nb_large > 0) {
+            int s = small[--nb_small];
+            int l = large[nb_large - 1];
+            table.threshold[first + s] = (uint32_t)(scaled[s] * 4294967296.0);
+            table.alias[first + s] = table.destination[first + l];
+            scaled[l] -= 1.0 - scaled[s];
+            if (scaled[l] < 1.0) {
+                nb_large--;
+                small[nb_small++] = l;
+            }
+        }
+
+        // Cases restantes pleines (aux erreurs d'arrondi près)
+        while (nb_large > 0) {
+            int l = large[--nb_large];
+            table.threshold[first + l] = UINT32_MAX;
+            table.alias[first + l] = table.destination[first + l];
+        }
+        while (nb_small > 0) {
+            int s = small[--nb_small];
+            table.threshold[first + s] = UINT32_MAX;
+            table.alias[first + s] = table.destination[first + s];
+        }
+    }
+
+    free(scaled);
+    free(small);
+    free(large);
+
+    return table;
+}
+
+void freeAliasTable(t_alias_table *table) {
+    free(table->offset);
+    free(table->threshold);
+    free(table->destination);
+    free(table->alias);
+    table->offset = NULL;
+    table->threshold = NULL;
+    table->destination = NULL;
+    table->alias = NULL;
+}
+
+// ============ Générateur aléatoire à compteur ============
+
+// Mélange de SplitMix64 appliqué à clé + compteur : chaque tirage est calculé
+// indépendamment, sans état à faire avancer ni à partager entre threads
+uint64_t counterRandom(uint64_t key, uint64_t counter) {
+    uint64_t z = key + counter * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Clé propre à chaque marcheur
+static uint64_t walkerKey(uint64_t seed, long long walker) {
+    return counterRandom(seed, (uint64_t)walker) | 1u;
+}
+
+// Un pas de la chaîne depuis state (0-indexé) avec le tirage r :
+// 32 bits hauts pour choisir la case, 32 bits bas pour la comparer au seuil
+static inline int aliasStep(const t_alias_table *table, int state, uint64_t r) {
+    int first = table->offset[state];
+    uint32_t nb = (uint32_t)(table->offset[state + 1] - first);
+    if (nb == 0) return state;  // Sommet sans arête sortante : le marcheur reste sur place
+
+    int bucket = first + (int)(((r >> 32) * nb) >> 32);
+    return ((uint32_t)r < table->threshold[bucket]) ? table->destination[bucket]
+                                                    : table->alias[bucket];
+}
+
+// ============ Simulation ============
+
+t_simulation_options defaultSimulationOptions() {
+    t_simulation_options options;
+    options.walkers = 1000;
+    options.steps = 0;
+    options.seed = 42;
+    options.start = 0;
+    options.trajectory_file = NULL;
+    return options;
+}
+
+// État initial du marcheur : fixé par options.start, sinon tiré uniformément
+// avec le compteur réservé UINT64_MAX (jamais utilisé par les pas)
+static int simulationStartState(t_simulation_options options, int nb_vertices, long long walker) {
+    if (options.start > 0) {
+        return options.start - 1;
+    }
+    uint64_t r = counterRandom(walkerKey(options.seed, walker), UINT64_MAX);
+    return (int)(((r >> 32) * (uint64_t)nb_vertices) >> 32);
+}
+
+// Contexte partagé par les tâches de simulation (une tâche par thread)
+typedef struct {
+    const t_alias_table *table;
+    t_simulation_options options;
+    int nb_tasks;
+    long long **visits;    // Compteurs de visites propres à chaque tâche
+    t_trajectory_writer *writer; // Écrivain de trajectoires (NULL si aucun)
+} t_simulation_context;
+
+static void simulationTask(int task_index, void *context) {
+    t_simulation_context *ctx = (t_simulation_context *)context;
+    const t_alias_table *table = ctx->table;
+    t_simulation_options options = ctx->options;
+    long long *visits = ctx->visits[task_index];
+    t_trajectory_writer *writer = ctx->writer;
+
+    long long first = options.walkers * task_index / ctx->nb_tasks;
+    long long last = options.walkers * (task_index + 1) / ctx->nb_tasks;
+
+    // La marche d'un marcheur ne dépend que de (graine, numéro, pas) :
+    // le résultat est le même quel que soit le nombre de threads.
+    // Les marcheurs avancent par paquets de SIMULATION_BATCH pour que les accès
+    // mémoire de marches différentes se recouvrent. Avec un fichier de trajectoires,
+    // les pas sont produits par tranches de TRAJECTORY_BLOCK_STEPS dans l'anneau de la tâche.
+    for (long long w0 = first; w0 < last; w0 += SIMULATION_BATCH) {
+        int batch = (int)((last - w0) < SIMULATION_BATCH ? (last - w0) : SIMULATION_BATCH);
+        uint64_t keys[SIMULATION_BATCH];
+        int states[SIMULATION_BATCH];
+        for (int b = 0; b < batch; b++) {
+            keys[b] = walkerKey(options.seed, w0 + b);
+            states[b] = simulationStartState(options, table->nb_vertices, w0 + b);
+        }
+
+        if (writer == NULL) {
+            for (long long step = 0; step < options.steps; step++) {
+                for (int b = 0; b < batch; b++) {
+                    states[b] = aliasStep(table, states[b], counterRandom(keys[b], (uint64_t)step));
+                    visits[states[b]]++;
+                }
+            }
+            continue;
+        }
+
+        // Positions 0..steps : l'état de départ (position 0) ouvre le premier
+        // bloc, puis l'état atteint après chaque pas
+        long long nb_positions = options.steps + 1;
+        for (long long position0 = 0; position0 < nb_positions; position0 += TRAJECTORY_BLOCK_STEPS) {
+            int count = (int)((nb_positions - position0) < TRAJECTORY_BLOCK_STEPS
+                              ? (nb_positions - position0) : TRAJECTORY_BLOCK_STEPS);
+            t_trajectory_block *blocks[SIMULATION_BATCH];
+            for (int b = 0; b < batch; b++) {
+                blocks[b] = reserveTrajectoryBlock(writer, task_index);
+                blocks[b]->walker = w0 + b;
+                blocks[b]->first_step = position0;
+                blocks[b]->count = count;
+            }
+            for (int i = 0; i < count; i++) {
+                long long position = position0 + i;
+                for (int b = 0; b < batch; b++) {
+                    if (position > 0) {
+                        states[b] = aliasStep(table, states[b],
+                                              counterRandom(keys[b], (uint64_t)(position - 1)));
+                        visits[states[b]]++;
+                    }
+                    blocks[b]->states[i] = states[b];
+                }
+            }
+            publishTrajectoryBlocks(writer, task_index);
+        }
+    }
+}
+
+t_simulation_result simulateWalks(t_adjacency_list adj_list, t_simulation_options options) {
+    if (options.start < 0 || options.start > adj_list.nb_vertices) {
+        fprintf(stderr, "Error: invalid start state %d\n", options.start);
+        exit(EXIT_FAILURE);
+    }
+
+    t_simulation_result result;
+    int n = adj_list.nb_vertices;
+    result.nb_vertices = n;
+    result.total_steps = options.walkers * options.steps;
+    result.visits = (long long *)calloc(n > 0 ? n : 1, sizeof(long long));
+    if (result.visits == NULL) {
+        perror("Failed to allocate memory for visit counts");
+        exit(EXIT_FAILURE);
+    }
+
+    t_alias_table table = createAliasTable(adj_list);
+
+    int nb_tasks = getThreadCount();
+    if (options.walkers < nb_tasks) nb_tasks = (int)(options.walkers > 0 ? options.walkers : 1);
+    result.nb_threads = nb_tasks;
+
+    t_simulation_context context;
+    context.table = &table;
+    context.options = options;
+    context.nb_tasks = nb_tasks;
+    context.visits = (long long **)malloc(nb_tasks * sizeof(long long *));
+    if (context.visits == NULL) {
+        perror("Failed to allocate memory for visit counts");
+        exit(EXIT_FAILURE);
+    }
+    for (int t = 0; t < nb_tasks; t++) {
+        context.visits[t] = (long long *)calloc(n > 0 ? n : 1, sizeof(long long));
+        if (context.visits[t] == NULL) {
+            perror("Failed to allocate memory for visit counts");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    context.writer = NULL;
+    if (options.trajectory_file != NULL) {
+        context.writer = openTrajectoryWriter(options.trajectory_file, nb_tasks, n, options.walkers,
+                                              options.steps, options.seed);
+    }
+
+    double start_time = getWallTime();
+    parallelFor(nb_tasks, simulationTask, &context);
+    result.trajectory_bytes = 0;
+    result.writer_waits = 0;
+    if (context.writer != NULL) {
+        result.trajectory_bytes = closeTrajectoryWriter(context.writer, &result.writer_waits);
+    }
+    result.seconds = getWallTime() - start_time;
+
+    // Fusion des compteurs (sommes entières : ordre sans importance)
+    for (int t = 0; t < nb_tasks; t++) {
+        for (int i = 0; i < n; i++) {
+            result.visits[i] += context.visits[t][i];
+        }
+        free(context.visits[t]);
+    }
+    free(context.visits);
+    freeAliasTable(&table);
+
+    return result;
+}
+
+// Entrée du classement des états par nombre de visites
+typedef struct {
+    long long visits;
+    int state;
+} t_visit_entry;
+
+static int compareVisitsDescending(const void *a, const void *b) {
+    const t_visit_entry *ea = (const t_visit_entry *)a;
+    const t_visit_entry *eb = (const t_visit_entry *)b;
+    if (ea->visits != eb->visits) return (ea->visits < eb->visits) ? 1 : -1;
+    return ea->state - eb->state;
+}
+
+void displaySimulationResult(t_simulation_result result) {
+    printf("\n=== Simulation de marches aléatoires ===\n");
+    printf("Pas simulés: %lld en %.3f s (%d threads)\n",
+           result.total_steps, result.seconds, result.nb_threads);
+    if (result.seconds > 0.0) {
+        double rate = result.total_steps / result.seconds;
+        printf("Débit: %.1f millions de pas/s (%.1f millions par thread)\n",
+               rate / 1e6, rate / 1e6 / result.nb_threads);
+    }
+    if (result.trajectory_bytes > 0) {
+        printf("Trajectoires: %.1f Mo écrits (%.2f octets/pas), %lld attentes d'écriture\n",
+               result.trajectory_bytes / 1048576.0,
+               result.total_steps > 0 ? (double)result.trajectory_bytes / result.total_steps : 0.0,
+               result.writer_waits);
+    }
+
+    // Au-delà de SIMULATION_DISPLAY_MAX états, seuls les plus visités sont affichés
+    int n = result.nb_vertices;
+    t_visit_entry *order = (t_visit_entry *)malloc((n > 0 ? n : 1) * sizeof(t_visit_entry));
+    if (order == NULL) {
+        perror("Failed to allocate memory for simulation display");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < n; i++) {
+        order[i].visits = result.visits[i];
+        order[i].state = i;
+    }
+    int nb_displayed = n;
+    if (n > SIMULATION_DISPLAY_MAX) {
+        qsort(order, n, sizeof(t_visit_entry), compareVisitsDescending);
+        nb_displayed = SIMULATION_DISPLAY_MAX;
+        printf("%d états les plus visités:\n", nb_displayed);
+    }
+
+    printf("  État      Visites    Fréquence\n");
+    for (int k = 0; k < nb_displayed; k++) {
+        int i = order[k].state;
+        double frequency = result.total_steps > 0 ? (double)result.visits[i] / result.total_steps : 0.0;
+        printf("  %4d %12lld %12.6f\n", i + 1, result.visits[i], frequency);
+    }
+    printf("========================================\n\n");
+
+    free(order);
+}
+
+void freeSimulationResult(t_simulation_result *result) {
+    if (result->visits != NULL) {
+        free(result->visits);
+        result->visits = NULL;
+    }
+}
+
+// ============ Distribution stationnaire par échantillonnage ============
+
+// Méthode régénérative : les excursions entre deux passages par l'état r sont
+// indépendantes. Avec Y_j le nombre de visites à j pendant une excursion et L sa
+// longueur, Pi_j = E[Y_j] / E[L], estimée par somme(Y_j) / somme(L). L'erreur type
+// découle du théorème central limite sur les couples (Y_j, L) :
+//   se_j = sqrt(somme((Y_j - Pi_j L)^2)) / somme(L)
+// La mémoire est de l'ordre de 40 octets par état de la classe et par tâche.
+
+t_sampling_options defaultSamplingOptions() {
+    t_sampling_options options;
+    options.relative_error = 0.01;
+    options.top_k = 10;
+    options.max_steps = 1000000000LL;
+    options.seed = 42;
+    return options;
+}
+
+// Accumulateurs d'une tâche (indices locaux de la classe)
+typedef struct {
+    long long *sum_visits; // somme des Y_j
+    double *sum_visits2;   // somme des Y_j^2
+    double *sum_cross;     // somme des Y_j L
+    int *visits;           // Y_j de l'excursion en cours
+    int *touched;          // États visités pendant l'excursion en cours
+    long long sum_length;  // somme des L
+    double sum_length2;    // somme des L^2
+    long long tours;
+} t_sampling_accumulator;
+
+typedef struct {
+    const t_alias_table *table;
+    const int *vertex_to_local;
+    int n;
+    int regeneration;
+    uint64_t key;          // Clé de la classe
+    long long first_tour;  // Premier tour de la passe
+    int nb_tasks;
+    t_sampling_accumulator *accumulators;
+} t_sampling_context;
+
+// La tâche t effectue les tours first_tour + t, first_tour + t + nb_tasks, ... de la passe.
+// Chaque tour a sa propre clé : les tours tirés ne dépendent pas du nombre de threads.
+static void samplingTask(int task_index, void *context) {
+    t_sampling_context *ctx = (t_sampling_context *)context;
+    t_sampling_accumulator *acc = &ctx->accumulators[task_index];
+
+    for (int k = task_index; k < SAMPLING_ROUND_TOURS; k += ctx->nb_tasks) {
+        uint64_t tour_key = counterRandom(ctx->key, (uint64_t)(ctx->first_tour + k)) | 1u;
+        int state = ctx->regeneration;
+        int nb_touched = 0;
+        long long length = 0;
+        do {
+            state = aliasStep(ctx->table, state, counterRandom(tour_key, (uint64_t)length));
+            length++;
+            int local = ctx->vertex_to_local[state];
+            if (acc->visits[local]++ == 0) {
+                acc->touched[nb_touched++] = local;
+            }
+        } while (state != ctx->regeneration);
+
+        for (int i = 0; i < nb_touched; i++) {
+            int local = acc->touched[i];
+            double y = acc->visits[local];
+            acc->sum_visits[local] += acc->visits[local];
+            acc->sum_visits2[local] += y * y;
+            acc->sum_cross[local] += y * (double)length;
+            acc->visits[local] = 0;
+        }
+        acc->sum_length += length;
+        acc->sum_length2 += (double)length * (double)length;
+        acc->tours++;
+    }
+}
+
+// Plus grande erreur relative parmi les top_k plus grandes estimations
+static double topKRelativeError(const double *estimate, const double *half_width, int n, int top_k) {
+    if (top_k > n) top_k = n;
+    int *best = (int *)malloc((top_k > 0 ? top_k : 1) * sizeof(int));
+    if (best == NULL) {
+        perror("Failed to allocate memory for top-K selection");
+        exit(EXIT_FAILURE);
+    }
+
+    // Insertion dans un tableau trié de top_k éléments : O(n top_k)
+    int nb = 0;
+    for (int j = 0; j < n; j++) {
+        if (nb == top_k && estimate[j] <= estimate[best[nb - 1]]) continue;
+        int pos = (nb < top_k) ? nb++ : nb - 1;
+        while (pos > 0 && estimate[best[pos - 1]] < estimate[j]) {
+            best[pos] = best[pos - 1];
+            pos--;
+        }
+        best[pos] = j;
+    }
+
+    double worst = 0.0;
+    for (int i = 0; i < nb; i++) {
+        int j = best[i];
+        double relative = estimate[j] > 0.0 ? half_width[j] / estimate[j] : INFINITY;
+        if (relative > worst) worst = relative;
+    }
+
+    free(best);
+    return worst;
+}
+
+// Choisir l'état de régénération : le plus visité d'une marche pilote
+static int chooseRegenerationState(const t_alias_table *table, t_class *classe,
+                                   const int *vertex_to_local, int *counts, uint64_t key) {
+    int state = classe->vertices[0] - 1;
+    int best = state;
+    for (long long step = 0; step < SAMPLING_PILOT_STEPS; step++) {
+        state = aliasStep(table, state, counterRandom(key, (uint64_t)step));
+        int local = vertex_to_local[state];
+        counts[local]++;
+        if (counts[local] > counts[vertex_to_local[best]]) best = state;
+    }
+    memset(counts, 0, classe->nb_vertices * sizeof(int));
+    return best;
+}
+
+t_sampling_result estimateClassStationary(const t_alias_table *table, t_partition partition,
+                                          int compo_index, const int *vertex_to_local,
+                                          t_sampling_options options) {
+    double start_time = getWallTime();
+    t_class *classe = &partition.classes[compo_index];
+    int n = classe->nb_vertices;
+
+    t_sampling_result result;
+    result.n = n;
+    result.estimate = (double *)calloc(n, sizeof(double));
+    result.half_width = (double *)calloc(n, sizeof(double));
+    if (result.estimate == NULL || result.half_width == NULL) {
+        perror("Failed to allocate memory for sampling result");
+        exit(EXIT_FAILURE);
+    }
+
+    int nb_tasks = getThreadCount();
+    t_sampling_context context;
+    context.table = table;
+    context.vertex_to_local = vertex_to_local;
+    context.n = n;
+    context.key = counterRandom(options.seed, (uint64_t)compo_index);
+    context.nb_tasks = nb_tasks;
+    context.accumulators = (t_sampling_accumulator *)calloc(nb_tasks, sizeof(t_sampling_accumulator));
+    if (context.accumulators == NULL) {
+        perror("Failed to allocate memory for sampling accumulators");
+        exit(EXIT_FAILURE);
+    }
+    for (int t = 0; t < nb_tasks; t++) {
+        t_sampling_accumulator *acc = &context.accumulators[t];
+        acc->sum_visits = (long long *)calloc(n, sizeof(long long));
+        acc->sum_visits2 = (double *)calloc(n, sizeof(double));
+        acc->sum_cross = (double *)calloc(n, sizeof(double));
+        acc->visits = (int *)calloc(n, sizeof(int));
+        acc->touched = (int *)malloc(n * sizeof(int));
+        if (acc->sum_visits == NULL || acc->sum_visits2 == NULL || acc->sum_cross == NULL ||
+            acc->visits == NULL || acc->touched == NULL) {
+            perror("Failed to allocate memory for sampling accumulators");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    context.regeneration = chooseRegenerationState(table, classe, vertex_to_local,
+                                                   context.accumulators[0].visits,
+                                                   counterRandom(context.key, UINT64_MAX));
+    result.regeneration = context.regeneration;
+
+    result.converged = 0;
+    result.achieved_error = INFINITY;
+    context.first_tour = 0;
+    while (1) {
+        parallelFor(nb_tasks, samplingTask, &context);
+        context.first_tour += SAMPLING_ROUND_TOURS;
+
+        // Totaux de toutes les tâches
+        long long sum_length = 0, tours = 0;
+        double sum_length2 = 0.0;
+        for (int t = 0; t < nb_tasks; t++) {
+            sum_length += context.accumulators[t].sum_length;
+            sum_length2 += context.accumulators[t].sum_length2;
+            tours += context.accumulators[t].tours;
+        }
+
+        for (int j = 0; j < n; j++) {
+            long long sum_visits = 0;
+            double sum_visits2 = 0.0, sum_cross = 0.0;
+            for (int t = 0; t < nb_tasks; t++) {
+                sum_visits += context.accumulators[t].sum_visits[j];
+                sum_visits2 += context.accumulators[t].sum_visits2[j];
+                sum_cross += context.accumulators[t].sum_cross[j];
+            }
+            double pi = (double)sum_visits / (double)sum_length;
+            double deviation = sum_visits2 - 2.0 * pi * sum_cross + pi * pi * sum_length2;
+            result.estimate[j] = pi;
+            result.half_width[j] = SAMPLING_Z * sqrt(deviation > 0.0 ? deviation : 0.0) / (double)sum_length;
+        }
+
+        result.tours = tours;
+        result.steps = sum_length;
+        result.achieved_error = topKRelativeError(result.estimate, result.half_width, n, options.top_k);
+        if (result.achieved_error <= options.relative_error) {
+            result.converged = 1;
+            break;
+        }
+        if (result.steps >= options.max_steps) break;
+    }
+    result.seconds = getWallTime() - start_time;
+
+    for (int t = 0; t < nb_tasks; t++) {
+        t_sampling_accumulator *acc = &context.accumulators[t];
+        free(acc->sum_visits);
+        free(acc->sum_visits2);
+        free(acc->sum_cross);
+        free(acc->visits);
+        free(acc->touched);
+    }
+    free(context.accumulators);
+
+    return result;
+}
+
+// Entrée du classement des états par probabilité estimée
+typedef struct {
+    double estimate;
+    int state;
+} t_estimate_entry;
+
+static int compareEstimatesDescending(const void *a, const void *b) {
+    const t_estimate_entry *ea = (const t_estimate_entry *)a;
+    const t_estimate_entry *eb = (const t_estimate_entry *)b;
+    if (ea->estimate != eb->estimate) return (ea->estimate < eb->estimate) ? 1 : -1;
+    return ea->state - eb->state;
+}
+
+void displaySamplingResult(t_sampling_result result, t_partition partition, int compo_index,
+                           t_sampling_options options) {
+    t_class *classe = &partition.classes[compo_index];
+
+    printf("Classe C%d: %lld excursions depuis l'état %d, %lld pas en %.3f s\n", compo_index + 1,
+           result.tours, result.regeneration + 1, result.steps, result.seconds);
+    if (result.converged) {
+        printf("Erreur relative visée atteinte: %.4f <= %.4f (top %d)\n",
+               result.achieved_error, options.relative_error, options.top_k);
+    } else {
+        printf("Attention: budget épuisé, erreur relative %.4f > %.4f (top %d)\n",
+               result.achieved_error, options.relative_error, options.top_k);
+    }
+
+    // Au-delà de SIMULATION_DISPLAY_MAX états, seuls les plus lourds sont affichés
+    int n = result.n;
+    t_estimate_entry *order = (t_estimate_entry *)malloc((n > 0 ? n : 1) * sizeof(t_estimate_entry));
+    if (order == NULL) {
+        perror("Failed to allocate memory for sampling display");
+        exit(EXIT_FAILURE);
+    }
+    for (int j = 0; j < n; j++) {
+        order[j].estimate = result.estimate[j];
+        order[j].state = j;
+    }
+    int nb_displayed = n;
+    if (n > SIMULATION_DISPLAY_MAX) {
+        qsort(order, n, sizeof(t_estimate_entry), compareEstimatesDescending);
+        nb_displayed = SIMULATION_DISPLAY_MAX;
+    }
+
+    printf("  État     Pi estimée   Intervalle à 95 %%\n");
+    for (int k = 0; k < nb_displayed; k++) {
+        int j = order[k].state;
+        printf("  %4d %12.6f   [%.6f, %.6f]\n", classe->vertices[j], result.estimate[j],
+               result.estimate[j] - result.half_width[j], result.estimate[j] + result.half_width[j]);
+    }
+    printf("\n");
+
+    free(order);
+}
+
+void freeSamplingResult(t_sampling_result *result) {
+    free(result->estimate);
+    free(result->half_width);
+    result->estimate = NULL;
+    result->half_width = NULL;
+}
+
+void estimateStationaryBySampling(t_adjacency_list adj_list, t_partition partition,
+                                  t_sampling_options options) {
+    printf("\n=== Distributions stationnaires par échantillonnage régénératif ===\n\n");
+
+    t_alias_table table = createAliasTable(adj_list);
+    int *vertex_to_class = createVertexToClassMap(partition, adj_list.nb_vertices);
+    int *vertex_to_local = createVertexToLocalIndexMap(partition, adj_list.nb_vertices);
+
+    for (int c = 0; c < partition.nb_classes; c++) {
+        if (!isPersistentClass(adj_list, partition, c, vertex_to_class)) continue;
+
+        t_sampling_result result = estimateClassStationary(&table, partition, c,
+                                                           vertex_to_local, options);
+        displaySamplingResult(result, partition, c, options);
+        freeSamplingResult(&result);
+    }
+
+    free(vertex_to_class);
+    free(vertex_to_local);
+    freeAliasTable(&table);
+
+    printf("==================================================================\n\n");
+}
@@ -0,0 +1,98 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <stdint.h>
+#include "graph.h"
+#include "tarjan.h"
+
+// Nombre de marcheurs avancés ensemble (chaînes de dépendance indépendantes)
+#define SIMULATION_BATCH 8
+
+// Nombre maximal d'états affichés dans le bilan d'une simulation
+#define SIMULATION_DISPLAY_MAX 20
+
+// Nombre de tours de régénération entre deux tests d'arrêt
+#define SAMPLING_ROUND_TOURS 1024
+
+// Longueur de la marche pilote qui choisit l'état de régénération
+#define SAMPLING_PILOT_STEPS 100000
+
+// Quantile de la loi normale pour les intervalles de confiance à 95 %
+#define SAMPLING_Z 1.96
+
+// Tables d'alias de tous les états (méthode de Vose) : un tirage par pas en O(1).
+// Les cases de l'état i occupent les indices offset[i] .. offset[i+1]-1.
+typedef struct {
+    int *offset;           // Début des cases de chaque état (taille nb_vertices+1)
+    uint32_t *threshold;   // Seuil d'acceptation de chaque case (sur 2^32)
+    int *destination;      // État (0-indexé) choisi si le tirage est sous le seuil
+    int *alias;            // État (0-indexé) choisi sinon
+    int nb_vertices;
+} t_alias_table;
+
+// Paramètres d'une simulation
+typedef struct {
+    long long walkers;     // Nombre de marcheurs indépendants
+    long long steps;       // Nombre de pas par marcheur
+    uint64_t seed;         // Graine (même graine => mêmes marches)
+    int start;             // État de départ (1-indexé), 0 = tirage uniforme
+    const char *trajectory_file; // Fichier de trajectoires (NULL = pas d'écriture)
+} t_simulation_options;
+
+// Résultat d'une simulation
+typedef struct {
+    long long *visits;     // Nombre de visites de chaque état (taille nb_vertices)
+    int nb_vertices;
+    long long total_steps; // Nombre total de pas simulés
+    double seconds;        // Durée de la simulation
+    int nb_threads;        // Nombre de threads utilisés
+    uint64_t trajectory_bytes; // Taille du fichier de trajectoires (0 si aucun)
+    long long writer_waits; // Attentes des simulateurs sur un anneau plein
+} t_simulation_result;
+
+// Paramètres de l'estimation par échantillonnage régénératif
+typedef struct {
+    double relative_error; // Demi-largeur relative visée sur les top_k états les plus lourds
+    int top_k;             // Nombre d'états surveillés pour l'arrêt
+    long long max_steps;   // Budget de pas par classe
+    uint64_t seed;         // Graine (même graine => mêmes estimations)
+} t_sampling_options;
+
+// Estimation de la distribution stationnaire d'une classe persistante
+typedef struct {
+    double *estimate;      // Pi estimée (indices locaux de la classe)
+    double *half_width;    // Demi-largeur de l'intervalle de confiance à 95 %
+    int n;                 // Nombre d'états de la classe
+    int regeneration;      // État de régénération (0-indexé dans le graphe)
+    long long tours;       // Nombre de retours à l'état de régénération
+    long long steps;       // Nombre de pas simulés
+    double achieved_error; // Plus grande erreur relative sur les top_k états
+    int converged;         // Erreur visée atteinte avant épuisement du budget
+    double seconds;        // Durée de l'estimation
+} t_sampling_result;
+
+// Fonctions pour les tables d'alias
+t_alias_table createAliasTable(t_adjacency_list adj_list);
+void freeAliasTable(t_alias_table *table);
+
+// Générateur à compteur : la valeur ne dépend que de (clé, compteur)
+uint64_t counterRandom(uint64_t key, uint64_t counter);
+
+// Fonctions de simulation
+t_simulation_options defaultSimulationOptions();
+t_simulation_result simulateWalks(t_adjacency_list adj_list, t_simulation_options options);
+void displaySimulationResult(t_simulation_result result);
+void freeSimulationResult(t_simulation_result *result);
+
+// Distribution stationnaire approchée de chaque classe persistante
+t_sampling_options defaultSamplingOptions();
+t_sampling_result estimateClassStationary(const t_alias_table *table, t_partition partition,
+                                          int compo_index, const int *vertex_to_local,
+                                          t_sampling_options options);
+void displaySamplingResult(t_sampling_result result, t_partition partition, int compo_index,
+                           t_sampling_options options);
+void freeSamplingResult(t_sampling_result *result);
+void estimateStationaryBySampling(t_adjacency_list adj_list, t_partition partition,
+                                  t_sampling_options options);
+
+#endif // SIMULATION_H
@@ -0,0 +1,1109 @@
+#include "solver.h"
+#include "utils.h"
+#include "parallel.h"
+#include <math.h>
+#include <string.h>
+
+// ============ Fonctions pour les résultats ============
+
+t_stationary_result createStationaryResult(int n) {
+    t_stationary_result result;
+    result.n = n;
+    result.iterations = 0;
+    result.difference = 0.0f;
+    result.residual = 0.0f;
+    result.converged = 0;
+    result.extrapolations = 0;
+    result.rejected = 0;
+    result.distribution = (float *)calloc(n, sizeof(float));
+    if (result.distribution == NULL) {
+        perror("Failed to allocate memory for stationary distribution");
+        exit(EXIT_FAILURE);
+    }
+    return result;
+}
+
+void freeStationaryResult(t_stationary_result *result) {
+    if (result->distribution != NULL) {
+        free(result->distribution);
+        result->distribution = NULL;
+    }
+}
+
+// Résidu ||Pi P - Pi||_1 (nul pour une distribution exactement stationnaire)
+float stationaryResidual(t_matrix sub_matrix, const float *distribution) {
+    int n = sub_matrix.rows;
+    double residual = 0.0;
+
+    for (int j = 0; j < n; j++) {
+        double sum = -(double)distribution[j];
+        for (int i = 0; i < n; i++) {
+            sum += (double)distribution[i] * sub_matrix.data[i][j];
+        }
+        residual += fabs(sum);
+    }
+
+    return (float)residual;
+}
+
+// ============ Factorisation LU par blocs ============
+
+// Factorisation PA = LU en place (L à diagonale unité sous la diagonale, U au-dessus).
+// Les colonnes sont traitées par panneaux de LU_BLOCK_SIZE, puis la sous-matrice
+// restante est mise à jour tuile par tuile pour rester dans le cache.
+// Retourne 0 si la factorisation réussit, k+1 si le pivot k est nul.
+int luFactorize(double *a, int n, int *pivots) {
+    for (int kb = 0; kb < n; kb += LU_BLOCK_SIZE) {
+        int kend = min(kb + LU_BLOCK_SIZE, n);
+
+        // Factorisation du panneau (colonnes kb..kend-1)
+        for (int k = kb; k < kend; k++) {
+            // Recherche du pivot
+            int p = k;
+            double max_val = fabs(a[(size_t)k * n + k]);
+            for (int i = k + 1; i < n; i++) {
+                double val = fabs(a[(size_t)i * n + k]);
+                if (val > max_val) {
+                    max_val = val;
+                    p = i;
+                }
+            }
+            pivots[k] = p;
+
+            if (max_val == 0.0) {
+                return k + 1;
+            }
+
+            // Échanger les lignes k et p
+            if (p != k) {
+                double *row_k = &a[(size_t)k * n];
+                double *row_p = &a[(size_t)p * n];
+                for (int j = 0; j < n; j++) {
+                    double temp = row_k[j];
+                    row_k[j] = row_p[j];
+                    row_p[j] = temp;
+                }
+            }
+
+            // Élimination limitée aux colonnes du panneau
+            double pivot = a[(size_t)k * n + k];
+            for (int i = k + 1; i < n; i++) {
+                double *row_i = &a[(size_t)i * n];
+                row_i[k] /= pivot;
+                double l = row_i[k];
+                if (l == 0.0) continue;
+                const double *row_k = &a[(size_t)k * n];
+                for (int j = k + 1; j < kend; j++) {
+                    row_i[j] -= l * row_k[j];
+                }
+            }
+        }
+
+        if (kend == n) break;
+
+        // Bloc U12 : résolution triangulaire L11 * U12 = A12
+        for (int k = kb; k < kend; k++) {
+            const double *row_k = &a[(size_t)k * n];
+            for (int i = k + 1; i < kend; i++) {
+                double *row_i = &a[(size_t)i * n];
+                double l = row_i[k];
+                if (l == 0.0) continue;
+                for (int j = kend; j < n; j++) {
+                    row_i[j] -= l * row_k[j];
+                }
+            }
+        }
+
+        // Mise à jour du bloc restant : A22 -= L21 * U12, par tuiles
+        for (int ib = kend; ib < n; ib += LU_BLOCK_SIZE) {
+            int iend = min(ib + LU_BLOCK_SIZE, n);
+            for (int jb = kend; jb < n; jb += LU_BLOCK_SIZE) {
+                int jend = min(jb + LU_BLOCK_SIZE, n);
+                for (int i = ib; i < iend; i++) {
+                    double *row_i = &a[(size_t)i * n];
+                    for (int k = kb; k < kend; k++) {
+                        double l = row_i[k];
+                        if (l == 0.0) continue;
+                        const double *row_k = &a[(size_t)k * n];
+                        for (int j = jb; j < jend; j++) {
+                            row_i[j] -= l * row_k[j];
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+// Résolution de A x = b à partir de la factorisation (b est remplacé par x)
+void luSolve(const double *lu, const int *pivots, int n, double *b) {
+    // Appliquer les permutations de lignes
+    for (int k = 0; k < n; k++) {
+        if (pivots[k] != k) {
+            double temp = b[k];
+            b[k] = b[pivots[k]];
+            b[pivots[k]] = temp;
+        }
+    }
+
+    // Descente (L à diagonale unité)
+    for (int i = 1; i < n; i++) {
+        const double *row_i = &lu[(size_t)i * n];
+        double sum = b[i];
+        for (int j = 0; j < i; j++) {
+            sum -= row_i[j] * b[j];
+        }
+        b[i] = sum;
+    }
+
+    // Remontée (U)
+    for (int i = n - 1; i >= 0; i--) {
+        const double *row_i = &lu[(size_t)i * n];
+        double sum = b[i];
+        for (int j = i + 1; j < n; j++) {
+            sum -= row_i[j] * b[j];
+        }
+        b[i] = sum / row_i[i];
+    }
+}
+
+// Mêmes étapes que luSolve, appliquées à des lignes entières de seconds membres :
+// chaque coefficient de L ou U est lu une seule fois pour tous les seconds membres
+void luSolveMultiple(const double *lu, const int *pivots, int n, double *b, int nb_rhs) {
+    for (int k = 0; k < n; k++) {
+        if (pivots[k] != k) {
+            double *row_k = &b[(size_t)k * nb_rhs];
+            double *row_p = &b[(size_t)pivots[k] * nb_rhs];
+            for (int r = 0; r < nb_rhs; r++) {
+                double temp = row_k[r];
+                row_k[r] = row_p[r];
+                row_p[r] = temp;
+            }
+        }
+    }
+
+    for (int i = 1; i < n; i++) {
+        const double *row_i = &lu[(size_t)i * n];
+        double *b_i = &b[(size_t)i * nb_rhs];
+        for (int j = 0; j < i; j++) {
+            double factor = row_i[j];
+            if (factor == 0.0) continue;
+            const double *b_j = &b[(size_t)j * nb_rhs];
+            for (int r = 0; r < nb_rhs; r++) {
+                b_i[r] -= factor * b_j[r];
+            }
+        }
+    }
+
+    for (int i = n - 1; i >= 0; i--) {
+        const double *row_i = &lu[(size_t)i * n];
+        double *b_i = &b[(size_t)i * nb_rhs];
+        for (int j = i + 1; j < n; j++) {
+            double factor = row_i[j];
+            if (factor == 0.0) continue;
+            const double *b_j = &b[(size_t)j * nb_rhs];
+            for (int r = 0; r < nb_rhs; r++) {
+                b_i[r] -= factor * b_j[r];
+            }
+        }
+        double inverse = 1.0 / row_i[i];
+        for (int r = 0; r < nb_rhs; r++) {
+            b_i[r] *= inverse;
+        }
+    }
+}
+
+// ============ Résolution directe ============
+
+t_stationary_result solveStationaryDirect(t_matrix sub_matrix) {
+    int n = sub_matrix.rows;
+    t_stationary_result result = createStationaryResult(n);
+
+    // Système transposé (P - I)^T Pi^T = 0, la dernière équation étant
+    // remplacée par la normalisation somme(Pi) = 1
+    double *a = (double *)malloc((size_t)n * n * sizeof(double));
+    double *b = (double *)calloc(n, sizeof(double));
+    int *pivots = (int *)malloc(n * sizeof(int));
+    if (a == NULL || b == NULL || pivots == NULL) {
+        perror("Failed to allocate memory for direct solver");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < n - 1; i++) {
+        for (int j = 0; j < n; j++) {
+            a[(size_t)i * n + j] = sub_matrix.data[j][i] - (i == j ? 1.0 : 0.0);
+        }
+    }
+    for (int j = 0; j < n; j++) {
+        a[(size_t)(n - 1) * n + j] = 1.0;
+    }
+    b[n - 1] = 1.0;
+
+    if (luFactorize(a, n, pivots) != 0) {
+        fprintf(stderr, "Error: singular system in direct stationary solver\n");
+    } else {
+        luSolve(a, pivots, n, b);
+        for (int i = 0; i < n; i++) {
+            result.distribution[i] = (float)b[i];
+        }
+        result.converged = 1;
+    }
+
+    result.iterations = 1;
+    result.residual = stationaryResidual(sub_matrix, result.distribution);
+    result.difference = result.residual;
+
+    free(a);
+    free(b);
+    free(pivots);
+
+    return result;
+}
+
+// ============ Méthodes de Krylov ============
+
+float stationaryResidualCSR(t_csr_matrix sub_matrix, const float *distribution) {
+    int n = sub_matrix.rows;
+    double *r = (double *)calloc(n, sizeof(double));
+    if (r == NULL) {
+        perror("Failed to allocate memory for residual");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < n; i++) {
+        r[i] -= distribution[i];
+        for (int k = sub_matrix.row_ptr[i]; k < sub_matrix.row_ptr[i + 1]; k++) {
+            r[sub_matrix.col_idx[k]] += (double)distribution[i] * sub_matrix.values[k];
+        }
+    }
+
+    double residual = 0.0;
+    for (int i = 0; i < n; i++) {
+        residual += fabs(r[i]);
+    }
+
+    free(r);
+    return (float)residual;
+}
+
+// Préconditionneur : z = M^-1 r
+typedef struct {
+    t_preconditioner type;
+    t_csr_matrix a;        // Matrice du système (structure partagée avec ILU)
+    double *diag_inv;      // Jacobi : inverses des coefficients diagonaux
+    double *lu;            // ILU(0) : coefficients L et U sur la structure de A
+    int *diag_pos;         // ILU(0) : position du coefficient diagonal de chaque ligne
+} t_precond;
+
+static double dot(const double *x, const double *y, int n) {
+    double sum = 0.0;
+    for (int i = 0; i < n; i++) {
+        sum += x[i] * y[i];
+    }
+    return sum;
+}
+
+static double norm2(const double *x, int n) {
+    return sqrt(dot(x, x, n));
+}
+
+// Système réduit pour Pi^T : on fixe Pi_{n-1} = 1, il reste
+// (I - P^T) x = P_{n-1,.}^T restreint aux n-1 premiers états.
+// Pour une classe irréductible, cette matrice est une M-matrice inversible.
+static t_csr_matrix buildReducedSystem(t_csr_matrix sub_matrix, double *b) {
+    int n = sub_matrix.rows;
+    int m = n - 1;
+    t_csr_matrix pt = transposeCSRMatrix(sub_matrix);
+
+    // Une entrée par coefficient de P^T plus la diagonale, au plus
+    t_csr_matrix a = createCSRMatrix(m, m, pt.nnz + m);
+
+    int pos = 0;
+    for (int i = 0; i < m; i++) {
+        b[i] = 0.0;
+        int diag_done = 0;
+        for (int k = pt.row_ptr[i]; k < pt.row_ptr[i + 1]; k++) {
+            int j = pt.col_idx[k];
+            if (j == n - 1) {
+                b[i] = pt.values[k];
+                continue;
+            }
+            if (!diag_done && j >= i) {
+                a.col_idx[pos] = i;
+                a.values[pos] = 1.0f;
+                pos++;
+                diag_done = 1;
+            }
+            if (j == i) {
+                a.values[pos - 1] -= pt.values[k];
+            } else {
+                a.col_idx[pos] = j;
+                a.values[pos] = -pt.values[k];
+                pos++;
+            }
+        }
+        if (!diag_done) {
+            a.col_idx[pos] = i;
+            a.values[pos] = 1.0f;
+            pos++;
+        }
+        a.row_ptr[i + 1] = pos;
+    }
+    a.nnz = pos;
+
+    freeCSRMatrix(&pt);
+    return a;
+}
+
+static t_precond createPreconditioner(t_csr_matrix a, t_preconditioner type) {
+    t_precond precond;
+    precond.type = type;
+    precond.a = a;
+    precond.diag_inv = NULL;
+    precond.lu = NULL;
+    precond.diag_pos = NULL;
+    int n = a.rows;
+
+    if (type == PRECOND_JACOBI) {
+        precond.diag_inv = (double *)malloc(n * sizeof(double));
+        if (precond.diag_inv == NULL) {
+            perror("Failed to allocate memory for Jacobi preconditioner");
+            exit(EXIT_FAILURE);
+        }
+        for (int i = 0; i < n; i++) {
+            precond.diag_inv[i] = 1.0;
+            for (int k = a.row_ptr[i]; k < a.row_ptr[i + 1]; k++) {
+                if (a.col_idx[k] == i && a.values[k] != 0.0f) {
+                    precond.diag_inv[i] = 1.0 / a.values[k];
+                }
+            }
+        }
+    } else if (type == PRECOND_ILU0) {
+        precond.lu = (double *)malloc((a.nnz > 0 ? a.nnz : 1) * sizeof(double));
+        precond.diag_pos = (int *)malloc(n * sizeof(int));
+        int *work = (int *)malloc(n * sizeof(int));
+        if (precond.lu == NULL || precond.diag_pos == NULL || work == NULL) {
+            perror("Failed to allocate memory for ILU(0) preconditioner");
+            exit(EXIT_FAILURE);
+        }
+
+        for (int k = 0; k < a.nnz; k++) {
+            precond.lu[k] = a.values[k];
+        }
+        for (int i = 0; i < n; i++) {
+            work[i] = -1;
+            for (int k = a.row_ptr[i]; k < a.row_ptr[i + 1]; k++) {
+                if (a.col_idx[k] == i) {
+                    precond.diag_pos[i] = k;
+                }
+            }
+        }
+
+        // Variante IKJ : élimination limitée à la structure de A
+        for (int i = 0; i < n; i++) {
+            for (int k = a.row_ptr[i]; k < a.row_ptr[i + 1]; k++) {
+                work[a.col_idx[k]] = k;
+            }
+            for (int k = a.row_ptr[i]; k < a.row_ptr[i + 1]; k++) {
+                int col = a.col_idx[k];
+                if (col >= i) break;
+                precond.lu[k] /= precond.lu[precond.diag_pos[col]];
+                double l = precond.lu[k];
+                for (int kk = precond.diag_pos[col] + 1; kk < a.row_ptr[col + 1]; kk++) {
+                    int pos = work[a.col_idx[kk]];
+                    if (pos != -1) {
+                        precond.lu[pos] -= l * precond.lu[kk];
+                    }
+                }
+            }
+            for (int k = a.row_ptr[i]; k < a.row_ptr[i + 1]; k++) {
+                work[a.col_idx[k]] = -1;
+            }
+        }
+
+        free(work);
+    }
+
+    return precond;
+}
+
+static void applyPreconditioner(const t_precond *precond, const double *r, double *z) {
+    int n = precond->a.rows;
+
+    switch (precond->type) {
+        case PRECOND_JACOBI:
+            for (int i = 0; i < n; i++) {
+                z[i] = precond->diag_inv[i] * r[i];
+            }
+            break;
+        case PRECOND_ILU0: {
+            const t_csr_matrix *a = &precond->a;
+            // Descente L y = r (L à diagonale unité)
+            for (int i = 0; i < n; i++) {
+                double sum = r[i];
+                for (int k = a->row_ptr[i]; k < precond->diag_pos[i]; k++) {
+                    sum -= precond->lu[k] * z[a->col_idx[k]];
+                }
+                z[i] = sum;
+            }
+            // Remontée U z = y
+            for (int i = n - 1; i >= 0; i--) {
+                double sum = z[i];
+                for (int k = precond->diag_pos[i] + 1; k < a->row_ptr[i + 1]; k++) {
+                    sum -= precond->lu[k] * z[a->col_idx[k]];
+                }
+                z[i] = sum / precond->lu[precond->diag_pos[i]];
+            }
+            break;
+        }
+        default:
+            memcpy(z, r, n * sizeof(double));
+            break;
+    }
+}
+
+static void freePreconditioner(t_precond *precond) {
+    free(precond->diag_inv);
+    free(precond->lu);
+    free(precond->diag_pos);
+}
+
+static double *allocVector(int n) {
+    double *v = (double *)calloc(n > 0 ? n : 1, sizeof(double));
+    if (v == NULL) {
+        perror("Failed to allocate memory for Krylov vector");
+        exit(EXIT_FAILURE);
+    }
+    return v;
+}
+
+// GMRES(m) préconditionné à droite, rotations de Givens
+// Retourne le nombre d'itérations, *rel_residual reçoit ||b - Ax|| / ||b||
+static int gmres(t_csr_matrix a, const t_precond *precond, const double *b, double *x,
+                 int restart, int max_iterations, double tolerance, double *rel_residual) {
+    int n = a.rows;
+    int m = restart;
+    double bnorm = norm2(b, n);
+    if (bnorm == 0.0) bnorm = 1.0;
+
+    double *v = allocVector((m + 1) * n);
+    double *h = allocVector((m + 1) * m);
+    double *cs = allocVector(m);
+    double *sn = allocVector(m);
+    double *g = allocVector(m + 1);
+    double *y = allocVector(m);
+    double *w = allocVector(n);
+    double *z = allocVector(n);
+
+    int iterations = 0;
+    double resid = 0.0;
+
+    while (1) {
+        // r = b - A x
+        csrMultiplyVector(a, x, w);
+        for (int i = 0; i < n; i++) {
+            w[i] = b[i] - w[i];
+        }
+        double beta = norm2(w, n);
+        resid = beta / bnorm;
+        if (resid <= tolerance || iterations >= max_iterations) break;
+
+        for (int i = 0; i < n; i++) {
+            v[i] = w[i] / beta;
+        }
+        for (int i = 0; i <= m; i++) {
+            g[i] = 0.0;
+        }
+        g[0] = beta;
+
+        int k = 0;
+        while (k < m && iterations < max_iterations) {
+            double *vk = &v[(size_t)k * n];
+            double *vnext = &v[(size_t)(k + 1) * n];
+
+            applyPreconditioner(precond, vk, z);
+            csrMultiplyVector(a, z, vnext);
+
+            // Orthogonalisation de Gram-Schmidt modifiée
+            for (int i = 0; i <= k; i++) {
+                double *vi = &v[(size_t)i * n];
+                double hik = dot(vnext, vi, n);
+                h[i * m + k] = hik;
+                for (int j = 0; j < n; j++) {
+                    vnext[j] -= hik * vi[j];
+                }
+            }
+            double hnext = norm2(vnext, n);
+            if (hnext > 0.0) {
+                for (int j = 0; j < n; j++) {
+                    vnext[j] /= hnext;
+                }
+            }
+
+            // Appliquer les rotations précédentes puis la nouvelle
+            for (int i = 0; i < k; i++) {
+                double temp = cs[i] * h[i * m + k] + sn[i] * h[(i + 1) * m + k];
+                h[(i + 1) * m + k] = -sn[i] * h[i * m + k] + cs[i] * h[(i + 1) * m + k];
+                h[i * m + k] = temp;
+            }
+            double denom = sqrt(h[k * m + k] * h[k * m + k] + hnext * hnext);
+            cs[k] = (denom > 0.0) ? h[k * m + k] / denom : 1.0;
+            sn[k] = (denom > 0.0) ? hnext / denom : 0.0;
+            h[k * m + k] = denom;
+            g[k + 1] = -sn[k] * g[k];
+            g[k] = cs[k] * g[k];
+
+            k++;
+            iterations++;
+            resid = fabs(g[k]) / bnorm;
+            if (resid <= tolerance || hnext == 0.0) break;
+        }
+
+        // Résoudre H y = g (triangulaire supérieure k x k)
+        for (int i = k - 1; i >= 0; i--) {
+            double sum = g[i];
+            for (int j = i + 1; j < k; j++) {
+                sum -= h[i * m + j] * y[j];
+            }
+            y[i] = (h[i * m + i] != 0.0) ? sum / h[i * m + i] : 0.0;
+        }
+
+        // x += M^-1 (V y)
+        for (int j = 0; j < n; j++) {
+            w[j] = 0.0;
+        }
+        for (int i = 0; i < k; i++) {
+            double *vi = &v[(size_t)i * n];
+            for (int j = 0; j < n; j++) {
+                w[j] += y[i] * vi[j];
+            }
+        }
+        applyPreconditioner(precond, w, z);
+        for (int j = 0; j < n; j++) {
+            x[j] += z[j];
+        }
+
+        if (resid <= tolerance || iterations >= max_iterations) {
+            // Résidu réel après mise à jour
+            csrMultiplyVector(a, x, w);
+            for (int i = 0; i < n; i++) {
+                w[i] = b[i] - w[i];
+            }
+            resid = norm2(w, n) / bnorm;
+            break;
+        }
+    }
+
+    free(v);
+    free(h);
+    free(cs);
+    free(sn);
+    free(g);
+    free(y);
+    free(w);
+    free(z);
+
+    *rel_residual = resid;
+    return iterations;
+}
+
+// BiCGStab préconditionné à droite
+static int bicgstab(t_csr_matrix a, const t_precond *precond, const double *b, double *x,
+                    int max_iterations, double tolerance, double *rel_residual) {
+    int n = a.rows;
+    double bnorm = norm2(b, n);
+    if (bnorm == 0.0) bnorm = 1.0;
+
+    double *r = allocVector(n);
+    double *r_hat = allocVector(n);
+    double *p = allocVector(n);
+    double *p_hat = allocVector(n);
+    double *v = allocVector(n);
+    double *s = allocVector(n);
+    double *s_hat = allocVector(n);
+    double *t = allocVector(n);
+
+    csrMultiplyVector(a, x, r);
+    for (int i = 0; i < n; i++) {
+        r[i] = b[i] - r[i];
+        r_hat[i] = r[i];
+    }
+
+    double rho = 1.0, alpha = 1.0, omega = 1.0;
+    double resid = norm2(r, n) / bnorm;
+    int iterations = 0;
+
+    while (resid > tolerance && iterations < max_iterations) {
+        iterations++;
+
+        double rho_new = dot(r_hat, r, n);
+        if (rho_new == 0.0) break;  // Rupture de la méthode
+
+        double beta = (rho_new / rho) * (alpha / omega);
+        for (int i = 0; i < n; i++) {
+            p[i] = r[i] + beta * (p[i] - omega * v[i]);
+        }
+        applyPreconditioner(precond, p, p_hat);
+        csrMultiplyVector(a, p_hat, v);
+
+        double rv = dot(r_hat, v, n);
+        if (rv == 0.0) break;
+        alpha = rho_new / rv;
+        for (int i = 0; i < n; i++) {
+            s[i] = r[i] - alpha * v[i];
+        }
+
+        if (norm2(s, n) / bnorm <= tolerance) {
+            for (int i = 0; i < n; i++) {
+                x[i] += alpha * p_hat[i];
+            }
+            resid = norm2(s, n) / bnorm;
+            break;
+        }
+
+        applyPreconditioner(precond, s, s_hat);
+        csrMultiplyVector(a, s_hat, t);
+        double tt = dot(t, t, n);
+        omega = (tt > 0.0) ? dot(t, s, n) / tt : 0.0;
+
+        for (int i = 0; i < n; i++) {
+            x[i] += alpha * p_hat[i] + omega * s_hat[i];
+            r[i] = s[i] - omega * t[i];
+        }
+        resid = norm2(r, n) / bnorm;
+        rho = rho_new;
+
+        if (omega == 0.0) break;
+    }
+
+    free(r);
+    free(r_hat);
+    free(p);
+    free(p_hat);
+    free(v);
+    free(s);
+    free(s_hat);
+    free(t);
+
+    *rel_residual = resid;
+    return iterations;
+}
+
+t_stationary_result solveStationaryKrylov(t_csr_matrix sub_matrix, t_stationary_options options) {
+    int n = sub_matrix.rows;
+    t_stationary_result result = createStationaryResult(n);
+
+    if (n == 1) {
+        result.distribution[0] = 1.0f;
+        result.converged = 1;
+        result.residual = stationaryResidualCSR(sub_matrix, result.distribution);
+        return result;
+    }
+
+    double *b = allocVector(n - 1);
+    t_csr_matrix a = buildReducedSystem(sub_matrix, b);
+    t_precond precond = createPreconditioner(a, options.preconditioner);
+
+    // Point de départ : distribution uniforme (Pi_{n-1} = 1)
+    double *x = allocVector(n);
+    for (int i = 0; i < n - 1; i++) {
+        x[i] = 1.0;
+    }
+
+    double rel_residual;
+    if (options.method == STATIONARY_BICGSTAB) {
+        result.iterations = bicgstab(a, &precond, b, x, options.max_iterations,
+                                     options.tolerance, &rel_residual);
+    } else {
+        int restart = options.gmres_restart > 0 ? options.gmres_restart : 30;
+        result.iterations = gmres(a, &precond, b, x, restart, options.max_iterations,
+                                  options.tolerance, &rel_residual);
+    }
+    x[n - 1] = 1.0;
+
+    // Normalisation : somme(Pi) = 1
+    double sum = 0.0;
+    for (int i = 0; i < n; i++) {
+        sum += x[i];
+    }
+    for (int i = 0; i < n; i++) {
+        result.distribution[i] = (float)(x[i] / sum);
+    }
+
+    result.difference = (float)rel_residual;
+    result.converged = (rel_residual <= options.tolerance);
+    result.residual = stationaryResidualCSR(sub_matrix, result.distribution);
+
+    freePreconditioner(&precond);
+    freeCSRMatrix(&a);
+    free(b);
+    free(x);
+
+    return result;
+}
+
+// Contexte partagé par les résolutions colonne par colonne
+typedef struct {
+    t_csr_matrix a;
+    const t_precond *precond;
+    double *b;
+    int nb_rhs;
+    int max_iterations;
+    double tolerance;
+    double *residuals;     // Résidu relatif final de chaque colonne
+} t_sparse_solve_context;
+
+static void sparseColumnTask(int task_index, void *context) {
+    t_sparse_solve_context *ctx = (t_sparse_solve_context *)context;
+    int n = ctx->a.rows;
+    double *rhs = allocVector(n);
+    double *x = allocVector(n);
+    for (int i = 0; i < n; i++) {
+        rhs[i] = ctx->b[(size_t)i * ctx->nb_rhs + task_index];
+    }
+
+    double rel_residual;
+    bicgstab(ctx->a, ctx->precond, rhs, x, ctx->max_iterations, ctx->tolerance, &rel_residual);
+    if (rel_residual > ctx->tolerance) {
+        // Rupture ou stagnation de BiCGStab : GMRES repart de l'itéré obtenu
+        gmres(ctx->a, ctx->precond, rhs, x, 30, ctx->max_iterations, ctx->tolerance, &rel_residual);
+    }
+
+    for (int i = 0; i < n; i++) {
+        ctx->b[(size_t)i * ctx->nb_rhs + task_index] = x[i];
+    }
+    ctx->residuals[task_index] = rel_residual;
+    free(rhs);
+    free(x);
+}
+
+double solveSparseMultiple(t_csr_matrix a, double *b, int nb_rhs, int max_iterations,
+                           double tolerance) {
+    t_precond precond = createPreconditioner(a, PRECOND_ILU0);
+    double *residuals = allocVector(nb_rhs);
+
+    t_sparse_solve_context context = {a, &precond, b, nb_rhs, max_iterations, tolerance, residuals};
+    parallelFor(nb_rhs, sparseColumnTask, &context);
+
+    double worst = 0.0;
+    for (int r = 0; r < nb_rhs; r++) {
+        if (residuals[r] > worst) worst = residuals[r];
+    }
+
+    free(residuals);
+    freePreconditioner(&precond);
+    return worst;
+}
+
+// ============ Gauss-Seidel et SOR ============
+
+// Ordre de parcours en largeur depuis l'état local 0 (la classe est fortement connexe)
+static int *bfsOrder(t_csr_matrix sub_matrix) {
+    int n = sub_matrix.rows;
+    int *order = (int *)malloc(n * sizeof(int));
+    int *visited = (int *)calloc(n, sizeof(int));
+    if (order == NULL || visited == NULL) {
+        perror("Failed to allocate memory for BFS ordering");
+        exit(EXIT_FAILURE);
+    }
+
+    int head = 0, tail = 0;
+    for (int start = 0; start < n; start++) {
+        if (visited[start]) continue;
+        visited[start] = 1;
+        order[tail++] = start;
+        while (head < tail) {
+            int u = order[head++];
+            for (int k = sub_matrix.row_ptr[u]; k < sub_matrix.row_ptr[u + 1]; k++) {
+                int v = sub_matrix.col_idx[k];
+                if (!visited[v]) {
+                    visited[v] = 1;
+                    order[tail++] = v;
+                }
+            }
+        }
+    }
+
+    free(visited);
+    return order;
+}
+
+t_stationary_result solveStationaryGaussSeidel(t_csr_matrix sub_matrix, t_stationary_options options) {
+    int n = sub_matrix.rows;
+    t_stationary_result result = createStationaryResult(n);
+    double omega = (options.method == STATIONARY_SOR) ? options.omega : 1.0;
+
+    // Structure transposée : la ligne j contient les prédécesseurs i de j et P_ij
+    t_csr_matrix pt = transposeCSRMatrix(sub_matrix);
+
+    int *order = NULL;
+    if (options.ordering == ORDERING_BFS) {
+        order = bfsOrder(sub_matrix);
+    }
+
+    // Un seul vecteur : chaque balayage réutilise les valeurs déjà mises à jour
+    double *pi = allocVector(n);
+    for (int i = 0; i < n; i++) {
+        pi[i] = 1.0 / n;
+    }
+
+    double diff = 0.0;
+    int iterations = 0;
+
+    while (iterations < options.max_iterations) {
+        iterations++;
+        diff = 0.0;
+
+        for (int idx = 0; idx < n; idx++) {
+            int j = (order != NULL) ? order[idx] : idx;
+            double sum = 0.0;
+            double p_jj = 0.0;
+            for (int k = pt.row_ptr[j]; k < pt.row_ptr[j + 1]; k++) {
+                int i = pt.col_idx[k];
+                if (i == j) {
+                    p_jj = pt.values[k];
+                } else {
+                    sum += pi[i] * pt.values[k];
+                }
+            }
+            if (p_jj >= 1.0) continue;  // État absorbant : Pi_j inchangé
+
+            double gs_value = sum / (1.0 - p_jj);
+            double new_value = (1.0 - omega) * pi[j] + omega * gs_value;
+            diff += fabs(new_value - pi[j]);
+            pi[j] = new_value;
+        }
+
+        // Renormaliser pour que la somme reste égale à 1
+        double total = 0.0;
+        for (int i = 0; i < n; i++) {
+            total += pi[i];
+        }
+        if (total > 0.0) {
+            for (int i = 0; i < n; i++) {
+                pi[i] /= total;
+            }
+            diff /= total;
+        }
+
+        if (diff <= options.tolerance) break;
+    }
+
+    for (int i = 0; i < n; i++) {
+        result.distribution[i] = (float)pi[i];
+    }
+    result.iterations = iterations;
+    result.difference = (float)diff;
+    result.converged = (diff <= options.tolerance);
+    result.residual = stationaryResidualCSR(sub_matrix, result.distribution);
+
+    free(pi);
+    free(order);
+    freeCSRMatrix(&pt);
+
+    return result;
+}
+
+// ============ Accélération de la méthode des puissances ============
+
+// Ramener les composantes négatives à 0 puis renormaliser (somme = 1)
+static void normalizeDistribution(double *x, int n) {
+    double total = 0.0;
+    for (int i = 0; i < n; i++) {
+        if (x[i] < 0.0) x[i] = 0.0;
+        total += x[i];
+    }
+    if (total > 0.0) {
+        for (int i = 0; i < n; i++) {
+            x[i] /= total;
+        }
+    }
+}
+
+static double l1Distance(const double *x, const double *y, int n) {
+    double sum = 0.0;
+    for (int i = 0; i < n; i++) {
+        sum += fabs(x[i] - y[i]);
+    }
+    return sum;
+}
+
+// Anderson : x_new = g(x) - dG gamma, gamma minimisant ||f - dF gamma||_2
+// Retourne 1 si l'extrapolation a pu être calculée
+static int andersonStep(const double *df, const double *dg, int hist, int n,
+                        const double *f, const double *gx, double *x_new) {
+    double a[ANDERSON_MAX_WINDOW * ANDERSON_MAX_WINDOW];
+    double gamma[ANDERSON_MAX_WINDOW];
+    int pivots[ANDERSON_MAX_WINDOW];
+
+    // Équations normales (dF^T dF) gamma = dF^T f, légèrement régularisées
+    for (int i = 0; i < hist; i++) {
+        for (int j = 0; j <= i; j++) {
+            double value = dot(&df[(size_t)i * n], &df[(size_t)j * n], n);
+            a[i * hist + j] = value;
+            a[j * hist + i] = value;
+        }
+        a[i * hist + i] *= 1.0 + 1e-10;
+        gamma[i] = dot(&df[(size_t)i * n], f, n);
+    }
+
+    if (luFactorize(a, hist, pivots) != 0) {
+        return 0;
+    }
+    luSolve(a, pivots, hist, gamma);
+
+    memcpy(x_new, gx, n * sizeof(double));
+    for (int i = 0; i < hist; i++) {
+        const double *dgi = &dg[(size_t)i * n];
+        for (int j = 0; j < n; j++) {
+            x_new[j] -= gamma[i] * dgi[j];
+        }
+    }
+    return 1;
+}
+
+// Aitken Delta^2 sur trois itérés successifs x0, x1, x2 : le rapport des écarts
+// successifs estime la valeur propre sous-dominante lambda, et la suite est
+// prolongée jusqu'à sa limite x2 + lambda / (1 - lambda) (x2 - x1)
+// Retourne 1 si l'extrapolation a pu être calculée
+static int aitkenStep(const double *x0, const double *x1, const double *x2, int n,
+                      double *x_new) {
+    double d1d2 = 0.0, d1d1 = 0.0;
+    for (int i = 0; i < n; i++) {
+        double d1 = x1[i] - x0[i];
+        double d2 = x2[i] - x1[i];
+        d1d2 += d1 * d2;
+        d1d1 += d1 * d1;
+    }
+    if (d1d1 == 0.0) return 0;
+
+    double lambda = d1d2 / d1d1;
+    if (lambda <= 0.0 || lambda >= 1.0) return 0;
+
+    double factor = lambda / (1.0 - lambda);
+    for (int i = 0; i < n; i++) {
+        x_new[i] = x2[i] + factor * (x2[i] - x1[i]);
+    }
+    return 1;
+}
+
+t_stationary_result solveStationaryAccelerated(t_csr_matrix sub_matrix, t_stationary_options options) {
+    int n = sub_matrix.rows;
+    t_stationary_result result = createStationaryResult(n);
+
+    int window = 0;
+    if (options.acceleration == ACCELERATION_ANDERSON) {
+        window = options.anderson_window;
+        if (window < 0) window = 0;
+        if (window > ANDERSON_MAX_WINDOW) window = ANDERSON_MAX_WINDOW;
+    }
+
+    double *x = allocVector(n);
+    double *gx = allocVector(n);
+    double *x_new = allocVector(n);
+    double *fallback = allocVector(n);   // Itéré simple g(x) utilisé en cas de rejet
+    double *x_prev = allocVector(n);     // Aitken : itéré précédent
+    double *f = allocVector(n);
+    double *f_prev = allocVector(n);
+    double *g_prev = allocVector(n);
+    double *df = allocVector(window * n);
+    double *dg = allocVector(window * n);
+
+    // Départ depuis le premier état, comme la première ligne de M^n
+    x[0] = 1.0;
+    csrVectorMultiply(sub_matrix, x, gx);
+    int iterations = 1;
+    double fnorm = l1Distance(gx, x, n);
+    double last_fnorm = fnorm;
+
+    int hist = 0, head = 0, have_prev = 0;
+    int plain_run = 0;
+    int extrapolated = 0;
+
+    while (fnorm > options.tolerance && iterations < options.max_iterations) {
+        if (extrapolated && fnorm > EXTRAPOLATION_SAFEGUARD * last_fnorm) {
+            // L'extrapolation a dégradé le résidu : retour à l'itéré simple
+            result.rejected++;
+            memcpy(x, fallback, n * sizeof(double));
+            csrVectorMultiply(sub_matrix, x, gx);
+            iterations++;
+            fnorm = l1Distance(gx, x, n);
+            hist = head = have_prev = plain_run = 0;
+            extrapolated = 0;
+            continue;
+        }
+        if (extrapolated) {
+            result.extrapolations++;
+        }
+        extrapolated = 0;
+        last_fnorm = fnorm;
+        memcpy(fallback, gx, n * sizeof(double));
+        memcpy(x_new, gx, n * sizeof(double));
+
+        if (window > 0) {
+            for (int i = 0; i < n; i++) {
+                f[i] = gx[i] - x[i];
+            }
+            if (have_prev) {
+                double *dfi = &df[(size_t)head * n];
+                double *dgi = &dg[(size_t)head * n];
+                for (int i = 0; i < n; i++) {
+                    dfi[i] = f[i] - f_prev[i];
+                    dgi[i] = gx[i] - g_prev[i];
+                }
+                head = (head + 1) % window;
+                if (hist < window) hist++;
+            }
+            memcpy(f_prev, f, n * sizeof(double));
+            memcpy(g_prev, gx, n * sizeof(double));
+            have_prev = 1;
+
+            if (hist > 0 && andersonStep(df, dg, hist, n, f, gx, x_new)) {
+                extrapolated = 1;
+            }
+        } else if (options.acceleration == ACCELERATION_AITKEN) {
+            // Laisser le mode sous-dominant s'imposer avant d'extrapoler
+            if (plain_run >= AITKEN_PERIOD) {
+                // x_prev, x, g(x) sont trois itérés successifs
+                extrapolated = aitkenStep(x_prev, x, gx, n, x_new);
+                plain_run = 0;
+            } else {
+                plain_run++;
+            }
+            memcpy(x_prev, x, n * sizeof(double));
+        }
+
+        normalizeDistribution(x_new, n);
+        memcpy(x, x_new, n * sizeof(double));
+        csrVectorMultiply(sub_matrix, x, gx);
+        iterations++;
+        fnorm = l1Distance(gx, x, n);
+    }
+    if (extrapolated && fnorm <= options.tolerance) {
+        result.extrapolations++;
+    }
+
+    normalizeDistribution(gx, n);
+    for (int i = 0; i < n; i++) {
+        result.distribution[i] = (float)gx[i];
+    }
+    result.iterations = iterations;
+    result.difference = (float)fnorm;
+    result.converged = (fnorm <= options.tolerance);
+    result.residual = stationaryResidualCSR(sub_matrix, result.distribution);
+
+    free(x);
+    free(gx);
+    free(x_new);
+    free(fallback);
+    free(x_prev);
+    free(f);
+    free(f_prev);
+    free(g_prev);
+    free(df);
+    free(dg);
+
+    return result;
+}
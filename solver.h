@@ -0,0 +1,64 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include "matrix.h"
+#include "sparse.h"
+
+// Taille des blocs pour la factorisation LU (optimisation du cache)
+#define LU_BLOCK_SIZE 64
+
+// Une extrapolation est rejetée si elle multiplie le résidu par plus que ce facteur
+#define EXTRAPOLATION_SAFEGUARD 1.0
+
+// Nombre d'itérations simples entre deux extrapolations d'Aitken
+#define AITKEN_PERIOD 10
+
+// Taille maximale de la fenêtre d'Anderson
+#define ANDERSON_MAX_WINDOW 20
+
+// Résultat d'un calcul de distribution stationnaire pour une classe
+typedef struct {
+    float *distribution;   // Distribution stationnaire (taille n)
+    int n;                 // Nombre d'états de la classe
+    int iterations;        // Nombre d'itérations effectuées
+    float difference;      // Dernière différence entre deux itérés
+    float residual;        // Résidu ||Pi(P - I)||_1
+    int converged;         // Indicateur de convergence
+    int extrapolations;    // Extrapolations acceptées (accélération)
+    int rejected;          // Extrapolations rejetées (retour à l'itération simple)
+} t_stationary_result;
+
+// Fonctions pour les résultats
+t_stationary_result createStationaryResult(int n);
+void freeStationaryResult(t_stationary_result *result);
+float stationaryResidual(t_matrix sub_matrix, const float *distribution);
+float stationaryResidualCSR(t_csr_matrix sub_matrix, const float *distribution);
+
+// Factorisation LU par blocs avec pivot partiel (matrice n x n stockée par lignes)
+int luFactorize(double *a, int n, int *pivots);
+void luSolve(const double *lu, const int *pivots, int n, double *b);
+
+// Résolution pour nb_rhs seconds membres à la fois (b : n lignes de nb_rhs valeurs)
+void luSolveMultiple(const double *lu, const int *pivots, int n, double *b, int nb_rhs);
+
+// Résolution creuse de A X = B pour nb_rhs seconds membres (b : n lignes de
+// nb_rhs valeurs, remplacées par la solution) : BiCGStab préconditionné par
+// ILU(0), repli sur GMRES si BiCGStab s'arrête avant tolerance. La factorisation
+// incomplète est partagée par les colonnes, résolues en parallèle. Chaque ligne
+// de A doit contenir son coefficient diagonal. Retourne le pire résidu relatif.
+double solveSparseMultiple(t_csr_matrix a, double *b, int nb_rhs, int max_iterations,
+                           double tolerance);
+
+// Résolution directe de Pi(P - I) = 0, somme(Pi) = 1
+t_stationary_result solveStationaryDirect(t_matrix sub_matrix);
+
+// Résolution itérative préconditionnée (GMRES(m) ou BiCGStab selon options.method)
+t_stationary_result solveStationaryKrylov(t_csr_matrix sub_matrix, t_stationary_options options);
+
+// Balayages de Gauss-Seidel (omega = 1) ou SOR en place sur la structure transposée
+t_stationary_result solveStationaryGaussSeidel(t_csr_matrix sub_matrix, t_stationary_options options);
+
+// Méthode des puissances sur un vecteur, accélérée par Aitken ou Anderson
+t_stationary_result solveStationaryAccelerated(t_csr_matrix sub_matrix, t_stationary_options options);
+
+#endif // SOLVER_H
@@ -0,0 +1,594 @@
+#include "sparse.h"
+#include "parallel.h"
+#include "spmv.h"
+#include "utils.h"
+#include <math.h>
+#include <string.h>
+
+// ============ Fonctions de base pour les matrices creuses ============
+
+t_csr_matrix createCSRMatrix(int rows, int cols, int nnz) {
+    t_csr_matrix matrix;
+    matrix.rows = rows;
+    matrix.cols = cols;
+    matrix.nnz = nnz;
+
+    matrix.row_ptr = (int *)calloc(rows + 1, sizeof(int));
+    matrix.col_idx = (int *)malloc((nnz > 0 ? nnz : 1) * sizeof(int));
+    matrix.values = (float *)malloc((nnz > 0 ? nnz : 1) * sizeof(float));
+    if (matrix.row_ptr == NULL || matrix.col_idx == NULL || matrix.values == NULL) {
+        perror("Failed to allocate memory for sparse matrix");
+        exit(EXIT_FAILURE);
+    }
+
+    return matrix;
+}
+
+void freeCSRMatrix(t_csr_matrix *matrix) {
+    free(matrix->row_ptr);
+    free(matrix->col_idx);
+    free(matrix->values);
+    matrix->row_ptr = NULL;
+    matrix->col_idx = NULL;
+    matrix->values = NULL;
+    matrix->nnz = 0;
+}
+
+t_csr_matrix copyCSRMatrix(t_csr_matrix matrix) {
+    t_csr_matrix copy = createCSRMatrix(matrix.rows, matrix.cols, matrix.nnz);
+    memcpy(copy.row_ptr, matrix.row_ptr, (matrix.rows + 1) * sizeof(int));
+    memcpy(copy.col_idx, matrix.col_idx, matrix.nnz * sizeof(int));
+    memcpy(copy.values, matrix.values, matrix.nnz * sizeof(float));
+    return copy;
+}
+
+t_csr_matrix identityCSRMatrix(int n) {
+    t_csr_matrix identity = createCSRMatrix(n, n, n);
+    for (int i = 0; i < n; i++) {
+        identity.row_ptr[i + 1] = i + 1;
+        identity.col_idx[i] = i;
+        identity.values[i] = 1.0f;
+    }
+    return identity;
+}
+
+float csrDensity(t_csr_matrix matrix) {
+    if (matrix.rows == 0 || matrix.cols == 0) return 0.0f;
+    return (float)((double)matrix.nnz / ((double)matrix.rows * matrix.cols));
+}
+
+// Transposition par tri par dénombrement (les colonnes du résultat restent triées)
+t_csr_matrix transposeCSRMatrix(t_csr_matrix matrix) {
+    t_csr_matrix result = createCSRMatrix(matrix.cols, matrix.rows, matrix.nnz);
+
+    // Compter les coefficients de chaque colonne
+    for (int k = 0; k < matrix.nnz; k++) {
+        result.row_ptr[matrix.col_idx[k] + 1]++;
+    }
+    for (int i = 0; i < result.rows; i++) {
+        result.row_ptr[i + 1] += result.row_ptr[i];
+    }
+
+    int *next = (int *)malloc((result.rows > 0 ? result.rows : 1) * sizeof(int));
+    if (next == NULL) {
+        perror("Failed to allocate memory for sparse transpose");
+        exit(EXIT_FAILURE);
+    }
+    memcpy(next, result.row_ptr, result.rows * sizeof(int));
+
+    for (int i = 0; i < matrix.rows; i++) {
+        for (int k = matrix.row_ptr[i]; k < matrix.row_ptr[i + 1]; k++) {
+            int pos = next[matrix.col_idx[k]]++;
+            result.col_idx[pos] = i;
+            result.values[pos] = matrix.values[k];
+        }
+    }
+
+    free(next);
+    return result;
+}
+
+t_csr_matrix lazyChainCSR(t_csr_matrix matrix) {
+    t_csr_matrix result = createCSRMatrix(matrix.rows, matrix.cols, matrix.nnz + matrix.rows);
+
+    int pos = 0;
+    for (int i = 0; i < matrix.rows; i++) {
+        int diag_done = 0;
+        for (int k = matrix.row_ptr[i]; k < matrix.row_ptr[i + 1]; k++) {
+            int j = matrix.col_idx[k];
+            if (!diag_done && j >= i) {
+                if (j != i) {
+                    result.col_idx[pos] = i;
+                    result.values[pos] = 0.5f;
+                    pos++;
+                }
+                diag_done = 1;
+            }
+            result.col_idx[pos] = j;
+            result.values[pos] = 0.5f * matrix.values[k] + (j == i ? 0.5f : 0.0f);
+            pos++;
+        }
+        if (!diag_done) {
+            result.col_idx[pos] = i;
+            result.values[pos] = 0.5f;
+            pos++;
+        }
+        result.row_ptr[i + 1] = pos;
+    }
+    result.nnz = pos;
+
+    return result;
+}
+
+void csrMultiplyVector(t_csr_matrix matrix, const double *x, double *y) {
+    for (int i = 0; i < matrix.rows; i++) {
+        double sum = 0.0;
+        for (int k = matrix.row_ptr[i]; k < matrix.row_ptr[i + 1]; k++) {
+            sum += matrix.values[k] * x[matrix.col_idx[k]];
+        }
+        y[i] = sum;
+    }
+}
+
+void csrVectorMultiply(t_csr_matrix matrix, const double *x, double *y) {
+    for (int j = 0; j < matrix.cols; j++) {
+        y[j] = 0.0;
+    }
+    for (int i = 0; i < matrix.rows; i++) {
+        double xi = x[i];
+        if (xi == 0.0) continue;
+        for (int k = matrix.row_ptr[i]; k < matrix.row_ptr[i + 1]; k++) {
+            y[matrix.col_idx[k]] += xi * matrix.values[k];
+        }
+    }
+}
+
+// ============ Construction depuis un graphe ============
+
+// Insérer un coefficient dans la ligne en cours (début row_start, fin *pos) en
+// gardant les colonnes triées ; une arête en double cumule les probabilités
+static void insertSortedEntry(t_csr_matrix *matrix, int row_start, int *pos, int col,
+                              float value) {
+    // Insertion triée par colonne (les listes sont courtes)
+    int k = *pos;
+    while (k > row_start && matrix->col_idx[k - 1] > col) {
+        matrix->col_idx[k] = matrix->col_idx[k - 1];
+        matrix->values[k] = matrix->values[k - 1];
+        k--;
+    }
+
+    if (k > row_start && matrix->col_idx[k - 1] == col) {
+        // Arête en double : cumuler les probabilités
+        matrix->values[k - 1] += value;
+        for (int m = k; m < *pos; m++) {
+            matrix->col_idx[m] = matrix->col_idx[m + 1];
+            matrix->values[m] = matrix->values[m + 1];
+        }
+    } else {
+        matrix->col_idx[k] = col;
+        matrix->values[k] = value;
+        (*pos)++;
+    }
+}
+
+t_csr_matrix adjacencyListToCSR(t_adjacency_list adj_list) {
+    int n = adj_list.nb_vertices;
+
+    int nnz = 0;
+    for (int i = 0; i < n; i++) {
+        t_cell *current = adj_list.lists[i].head;
+        while (current != NULL) {
+            nnz++;
+            current = current->next;
+        }
+    }
+
+    t_csr_matrix matrix = createCSRMatrix(n, n, nnz);
+
+    int pos = 0;
+    for (int i = 0; i < n; i++) {
+        int row_start = pos;
+        t_cell *current = adj_list.lists[i].head;
+        while (current != NULL) {
+            insertSortedEntry(&matrix, row_start, &pos, current->destination - 1,
+                              current->probability);
+            current = current->next;
+        }
+        matrix.row_ptr[i + 1] = pos;
+    }
+    matrix.nnz = pos;
+
+    return matrix;
+}
+
+// La transposée se lit directement dans l'index inverse du graphe : la ligne j
+// contient les prédécesseurs i de j, déjà triés, et P_ij
+t_csr_matrix adjacencyListToTransposedCSR(t_adjacency_list adj_list) {
+    int n = adj_list.nb_vertices;
+    const t_reverse_index *index = getReverseIndex(adj_list);
+
+    t_csr_matrix matrix = createCSRMatrix(n, n, index->nb_edges);
+
+    int pos = 0;
+    for (int j = 0; j < n; j++) {
+        int row_start = pos;
+        for (int e = index->offsets[j]; e < index->offsets[j + 1]; e++) {
+            if (pos > row_start && matrix.col_idx[pos - 1] == index->sources[e]) {
+                // Arête en double : cumuler les probabilités
+                matrix.values[pos - 1] += index->probabilities[e];
+            } else {
+                matrix.col_idx[pos] = index->sources[e];
+                matrix.values[pos] = index->probabilities[e];
+                pos++;
+            }
+        }
+        matrix.row_ptr[j + 1] = pos;
+    }
+    matrix.nnz = pos;
+
+    return matrix;
+}
+
+// ============ Extraction de sous-matrice creuse ============
+
+t_csr_matrix classSubMatrixCSR(t_adjacency_list adj_list, t_partition partition,
+                               int compo_index, const int *vertex_to_class,
+                               const int *vertex_to_local) {
+    if (compo_index < 0 || compo_index >= partition.nb_classes) {
+        fprintf(stderr, "Error: invalid component index\n");
+        exit(EXIT_FAILURE);
+    }
+
+    t_class *classe = &partition.classes[compo_index];
+    int n = classe->nb_vertices;
+
+    // Compter les arêtes internes à la classe
+    int nnz = 0;
+    for (int i = 0; i < n; i++) {
+        t_cell *current = adj_list.lists[classe->vertices[i] - 1].head;
+        while (current != NULL) {
+            if (vertex_to_class[current->destination - 1] == compo_index) {
+                nnz++;
+            }
+            current = current->next;
+        }
+    }
+
+    t_csr_matrix sub = createCSRMatrix(n, n, nnz);
+
+    int pos = 0;
+    for (int i = 0; i < n; i++) {
+        int row_start = pos;
+        t_cell *current = adj_list.lists[classe->vertices[i] - 1].head;
+        while (current != NULL) {
+            int dest = current->destination - 1;
+            if (vertex_to_class[dest] == compo_index) {
+                insertSortedEntry(&sub, row_start, &pos, vertex_to_local[dest],
+                                  current->probability);
+            }
+            current = current->next;
+        }
+        sub.row_ptr[i + 1] = pos;
+    }
+    sub.nnz = pos;
+
+    return sub;
+}
+
+// ============ Conversions avec les matrices denses ============
+
+t_matrix csrToMatrix(t_csr_matrix matrix) {
+    t_matrix dense = createEmptyMatrix(matrix.rows);
+    for (int i = 0; i < matrix.rows; i++) {
+        for (int k = matrix.row_ptr[i]; k < matrix.row_ptr[i + 1]; k++) {
+            dense.data[i][matrix.col_idx[k]] = matrix.values[k];
+        }
+    }
+    return dense;
+}
+
+t_csr_matrix matrixToCSR(t_matrix matrix) {
+    int nnz = 0;
+    for (int i = 0; i < matrix.rows; i++) {
+        for (int j = 0; j < matrix.cols; j++) {
+            if (matrix.data[i][j] != 0.0f) nnz++;
+        }
+    }
+
+    t_csr_matrix result = createCSRMatrix(matrix.rows, matrix.cols, nnz);
+    int pos = 0;
+    for (int i = 0; i < matrix.rows; i++) {
+        for (int j = 0; j < matrix.cols; j++) {
+            if (matrix.data[i][j] != 0.0f) {
+                result.col_idx[pos] = j;
+                result.values[pos] = matrix.data[i][j];
+                pos++;
+            }
+        }
+        result.row_ptr[i + 1] = pos;
+    }
+    return result;
+}
+
+// ============ Produit creux x creux (SpGEMM) ============
+
+// Résultat d'un paquet de lignes calculé par un thread
+typedef struct {
+    int *col_idx;
+    float *values;
+    int nnz;
+    int capacity;
+} t_spgemm_chunk;
+
+typedef struct {
+    t_csr_matrix a;
+    t_csr_matrix b;
+    float drop_tolerance;
+    int rows_per_chunk;
+    t_spgemm_chunk *chunks;
+    int *row_nnz;          // Nombre de coefficients de chaque ligne du résultat
+} t_spgemm_job;
+
+static int compareInts(const void *x, const void *y) {
+    int a = *(const int *)x;
+    int b = *(const int *)y;
+    return (a > b) - (a < b);
+}
+
+static void appendChunkEntry(t_spgemm_chunk *chunk, int col, float value) {
+    if (chunk->nnz >= chunk->capacity) {
+        chunk->capacity = chunk->capacity > 0 ? 2 * chunk->capacity : 1024;
+        chunk->col_idx = (int *)realloc(chunk->col_idx, chunk->capacity * sizeof(int));
+        chunk->values = (float *)realloc(chunk->values, chunk->capacity * sizeof(float));
+        if (chunk->col_idx == NULL || chunk->values == NULL) {
+            perror("Failed to reallocate memory for SpGEMM chunk");
+            exit(EXIT_FAILURE);
+        }
+    }
+    chunk->col_idx[chunk->nnz] = col;
+    chunk->values[chunk->nnz] = value;
+    chunk->nnz++;
+}
+
+// Algorithme de Gustavson : chaque ligne i du résultat est la combinaison des
+// lignes k de B pondérées par A[i][k], accumulée dans un tableau dense
+static void spgemmTask(int task_index, void *context) {
+    t_spgemm_job *job = (t_spgemm_job *)context;
+    int row_start = task_index * job->rows_per_chunk;
+    int row_end = min(row_start + job->rows_per_chunk, job->a.rows);
+    int n = job->b.cols;
+
+    float *accumulator = (float *)malloc((n > 0 ? n : 1) * sizeof(float));
+    int *marker = (int *)malloc((n > 0 ? n : 1) * sizeof(int));
+    int *row_cols = (int *)malloc((n > 0 ? n : 1) * sizeof(int));
+    if (accumulator == NULL || marker == NULL || row_cols == NULL) {
+        perror("Failed to allocate memory for SpGEMM accumulator");
+        exit(EXIT_FAILURE);
+    }
+    for (int j = 0; j < n; j++) {
+        marker[j] = -1;
+    }
+
+    t_spgemm_chunk *chunk = &job->chunks[task_index];
+    for (int i = row_start; i < row_end; i++) {
+        int count = 0;
+        for (int ka = job->a.row_ptr[i]; ka < job->a.row_ptr[i + 1]; ka++) {
+            int k = job->a.col_idx[ka];
+            float a_ik = job->a.values[ka];
+            for (int kb = job->b.row_ptr[k]; kb < job->b.row_ptr[k + 1]; kb++) {
+                int j = job->b.col_idx[kb];
+                if (marker[j] != i) {
+                    marker[j] = i;
+                    accumulator[j] = a_ik * job->b.values[kb];
+                    row_cols[count++] = j;
+                } else {
+                    accumulator[j] += a_ik * job->b.values[kb];
+                }
+            }
+        }
+
+        qsort(row_cols, count, sizeof(int), compareInts);
+
+        int kept = 0;
+        for (int c = 0; c < count; c++) {
+            int j = row_cols[c];
+            if (job->drop_tolerance > 0.0f && fabsf(accumulator[j]) < job->drop_tolerance) {
+                continue;
+            }
+            appendChunkEntry(chunk, j, accumulator[j]);
+            kept++;
+        }
+        job->row_nnz[i] = kept;
+    }
+
+    free(accumulator);
+    free(marker);
+    free(row_cols);
+}
+
+t_csr_matrix multiplyCSRMatrices(t_csr_matrix a, t_csr_matrix b, float drop_tolerance) {
+    if (a.cols != b.rows) {
+        fprintf(stderr, "Error: incompatible sparse matrix dimensions for multiplication\n");
+        exit(EXIT_FAILURE);
+    }
+
+    t_spgemm_job job;
+    job.a = a;
+    job.b = b;
+    job.drop_tolerance = drop_tolerance;
+
+    // Plusieurs paquets par thread pour équilibrer les lignes de coût inégal
+    int nb_chunks = getThreadCount() * 4;
+    job.rows_per_chunk = (a.rows + nb_chunks - 1) / nb_chunks;
+    if (job.rows_per_chunk < 64) job.rows_per_chunk = 64;
+    nb_chunks = (a.rows + job.rows_per_chunk - 1) / job.rows_per_chunk;
+
+    job.chunks = (t_spgemm_chunk *)calloc(nb_chunks > 0 ? nb_chunks : 1, sizeof(t_spgemm_chunk));
+    job.row_nnz = (int *)calloc(a.rows > 0 ? a.rows : 1, sizeof(int));
+    if (job.chunks == NULL || job.row_nnz == NULL) {
+        perror("Failed to allocate memory for SpGEMM");
+        exit(EXIT_FAILURE);
+    }
+
+    parallelFor(nb_chunks, spgemmTask, &job);
+
+    // Assembler les paquets dans l'ordre des lignes
+    int nnz = 0;
+    for (int c = 0; c < nb_chunks; c++) {
+        nnz += job.chunks[c].nnz;
+    }
+    t_csr_matrix result = createCSRMatrix(a.rows, b.cols, nnz);
+    for (int i = 0; i < a.rows; i++) {
+        result.row_ptr[i + 1] = result.row_ptr[i] + job.row_nnz[i];
+    }
+    int pos = 0;
+    for (int c = 0; c < nb_chunks; c++) {
+        if (job.chunks[c].nnz > 0) {
+            memcpy(&result.col_idx[pos], job.chunks[c].col_idx, job.chunks[c].nnz * sizeof(int));
+            memcpy(&result.values[pos], job.chunks[c].values, job.chunks[c].nnz * sizeof(float));
+            pos += job.chunks[c].nnz;
+        }
+        free(job.chunks[c].col_idx);
+        free(job.chunks[c].values);
+    }
+
+    free(job.chunks);
+    free(job.row_nnz);
+    return result;
+}
+
+// Puissance par élévations au carré successives. Tant que les facteurs restent
+// creux, les produits utilisent SpGEMM ; dès que la densité d'un facteur dépasse
+// density_cutoff, le calcul se poursuit avec le produit dense.
+t_csr_matrix csrMatrixPower(t_csr_matrix matrix, int power, float drop_tolerance,
+                            float density_cutoff) {
+    if (power < 0) {
+        fprintf(stderr, "Error: power must be non-negative\n");
+        exit(EXIT_FAILURE);
+    }
+
+    t_csr_matrix result = identityCSRMatrix(matrix.rows);
+    t_csr_matrix base = copyCSRMatrix(matrix);
+
+    while (power > 0) {
+        if (csrDensity(result) > density_cutoff || csrDensity(base) > density_cutoff) {
+            break;
+        }
+        if (power & 1) {
+            t_csr_matrix temp = multiplyCSRMatrices(result, base, drop_tolerance);
+            freeCSRMatrix(&result);
+            result = temp;
+        }
+        power >>= 1;
+        if (power > 0) {
+            t_csr_matrix temp = multiplyCSRMatrices(base, base, drop_tolerance);
+            freeCSRMatrix(&base);
+            base = temp;
+        }
+    }
+
+    if (power > 0) {
+        // Remplissage trop important : fin du calcul en dense
+        t_matrix dense_result = csrToMatrix(result);
+        t_matrix dense_base = csrToMatrix(base);
+        t_matrix temp = borrowMatrix(defaultMatrixPool(), matrix.rows);
+
+        while (power > 0) {
+            if (power & 1) {
+                multiplyMatrices(dense_result, dense_base, temp);
+                copyMatrix(dense_result, temp);
+            }
+            power >>= 1;
+            if (power > 0) {
+                multiplyMatrices(dense_base, dense_base, temp);
+                copyMatrix(dense_base, temp);
+            }
+        }
+
+        freeCSRMatrix(&result);
+        result = matrixToCSR(dense_result);
+        freeMatrix(&dense_result);
+        freeMatrix(&dense_base);
+        returnMatrix(defaultMatrixPool(), &temp);
+    }
+
+    freeCSRMatrix(&base);
+    return result;
+}
+
+// ============ Produit par un bloc de vecteurs (SpMM) ============
+
+typedef struct {
+    t_csr_matrix matrix;
+    const double *x;
+    double *y;
+    int nb_vectors;
+    int rows_per_chunk;
+} t_spmm_job;
+
+// Une ligne de Y = A X : les nb_vectors valeurs d'une ligne de X sont contiguës,
+// ce qui donne une boucle interne vectorisable. Appelée avec une largeur
+// constante, la boucle est entièrement déroulée par le compilateur.
+static inline void spmmRow(t_csr_matrix matrix, const double *x, double *y_row,
+                           int row, int width) {
+    double accumulator[SPMM_MAX_VECTORS];
+    for (int s = 0; s < width; s++) {
+        accumulator[s] = 0.0;
+    }
+    for (int k = matrix.row_ptr[row]; k < matrix.row_ptr[row + 1]; k++) {
+        double a = matrix.values[k];
+        const double *x_row = &x[(size_t)matrix.col_idx[k] * width];
+        for (int s = 0; s < width; s++) {
+            accumulator[s] += a * x_row[s];
+        }
+    }
+    for (int s = 0; s < width; s++) {
+        y_row[s] = accumulator[s];
+    }
+}
+
+static void spmmTask(int task_index, void *context) {
+    t_spmm_job *job = (t_spmm_job *)context;
+    int row_start = task_index * job->rows_per_chunk;
+    int row_end = min(row_start + job->rows_per_chunk, job->matrix.rows);
+    int width = job->nb_vectors;
+
+    for (int i = row_start; i < row_end; i++) {
+        double *y_row = &job->y[(size_t)i * width];
+        if (width == SPMM_MAX_VECTORS) {
+            spmmRow(job->matrix, job->x, y_row, i, SPMM_MAX_VECTORS);
+        } else {
+            spmmRow(job->matrix, job->x, y_row, i, width);
+        }
+    }
+}
+
+void csrMultiplyBlock(t_csr_matrix matrix, const double *x, double *y, int nb_vectors) {
+    if (nb_vectors < 1 || nb_vectors > SPMM_MAX_VECTORS) {
+        fprintf(stderr, "Error: SpMM block width must be between 1 and %d\n", SPMM_MAX_VECTORS);
+        exit(EXIT_FAILURE);
+    }
+
+    // Un seul vecteur : le noyau SpMV pull (boucle vectorisée par chargements indexés)
+    if (nb_vectors == 1) {
+        spmvPull(matrix, x, y);
+        return;
+    }
+
+    t_spmm_job job;
+    job.matrix = matrix;
+    job.x = x;
+    job.y = y;
+    job.nb_vectors = nb_vectors;
+
+    // Un produit trop petit ne rentabilise pas le lancement des threads
+    int nb_chunks = 1;
+    if ((long long)matrix.nnz * nb_vectors >= SPMM_PARALLEL_MIN_WORK) {
+        nb_chunks = getThreadCount() * 4;
+    }
+    job.rows_per_chunk = (matrix.rows + nb_chunks - 1) / nb_chunks;
+    if (job.rows_per_chunk < 64) job.rows_per_chunk = 64;
+    nb_chunks = (matrix.rows + job.rows_per_chunk - 1) / job.rows_per_chunk;
+
+    parallelFor(nb_chunks, spmmTask, &job);
+}
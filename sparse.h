@@ -0,0 +1,69 @@
+#ifndef SPARSE_H
+#define SPARSE_H
+
+#include "graph.h"
+#include "tarjan.h"
+#include "matrix.h"
+
+// Densité au-delà de laquelle les puissances creuses passent au produit dense
+#define SPGEMM_DENSITY_CUTOFF 0.25f
+
+// Nombre maximal de vecteurs traités ensemble par le produit par blocs (SpMM)
+#define SPMM_MAX_VECTORS 16
+
+// Travail (coefficients x vecteurs) en dessous duquel le SpMM reste séquentiel
+#define SPMM_PARALLEL_MIN_WORK (1 << 18)
+
+// Structure pour une matrice creuse au format CSR (Compressed Sparse Row)
+typedef struct {
+    int *row_ptr;          // Début de chaque ligne dans col_idx/values (taille rows+1)
+    int *col_idx;          // Indice de colonne de chaque coefficient (trié par ligne)
+    float *values;         // Valeur de chaque coefficient
+    int rows;              // Nombre de lignes
+    int cols;              // Nombre de colonnes
+    int nnz;               // Nombre de coefficients non nuls
+} t_csr_matrix;
+
+// Fonctions de base pour les matrices creuses
+t_csr_matrix createCSRMatrix(int rows, int cols, int nnz);
+void freeCSRMatrix(t_csr_matrix *matrix);
+t_csr_matrix copyCSRMatrix(t_csr_matrix matrix);
+t_csr_matrix identityCSRMatrix(int n);
+t_csr_matrix transposeCSRMatrix(t_csr_matrix matrix);
+float csrDensity(t_csr_matrix matrix);
+
+// Conversions entre matrices creuses et denses
+t_csr_matrix adjacencyListToCSR(t_adjacency_list adj_list);
+t_csr_matrix adjacencyListToTransposedCSR(t_adjacency_list adj_list);
+t_matrix csrToMatrix(t_csr_matrix matrix);
+t_csr_matrix matrixToCSR(t_matrix matrix);
+
+// Produit creux x creux (Gustavson, parallélisé par paquets de lignes)
+// Les coefficients de valeur absolue inférieure à drop_tolerance sont supprimés
+t_csr_matrix multiplyCSRMatrices(t_csr_matrix a, t_csr_matrix b, float drop_tolerance);
+
+// Puissance creuse, avec repli sur le produit dense au-delà de density_cutoff
+t_csr_matrix csrMatrixPower(t_csr_matrix matrix, int power, float drop_tolerance,
+                            float density_cutoff);
+
+// Chaîne paresseuse (P + I) / 2 (ajoute la diagonale si elle est absente)
+t_csr_matrix lazyChainCSR(t_csr_matrix matrix);
+
+// Produit matrice-vecteur y = A x
+void csrMultiplyVector(t_csr_matrix matrix, const double *x, double *y);
+
+// Produit vecteur-matrice y = x A (une étape de la chaîne pour une distribution x)
+void csrVectorMultiply(t_csr_matrix matrix, const double *x, double *y);
+
+// Produit par un bloc de vecteurs Y = A X (SpMM), parallélisé par paquets de lignes.
+// X et Y sont rangés par lignes : les nb_vectors valeurs de chaque ligne sont
+// contiguës (nb_vectors <= SPMM_MAX_VECTORS). Appliqué à la transposée de P,
+// il fait avancer d'un pas nb_vectors distributions à la fois.
+void csrMultiplyBlock(t_csr_matrix matrix, const double *x, double *y, int nb_vectors);
+
+// Extraction de la sous-matrice creuse d'une classe directement depuis le graphe
+t_csr_matrix classSubMatrixCSR(t_adjacency_list adj_list, t_partition partition,
+                               int compo_index, const int *vertex_to_class,
+                               const int *vertex_to_local);
+
+#endif // SPARSE_H
@@ -0,0 +1,368 @@
+#include "spmv.h"
+#include "parallel.h"
+#include "utils.h"
+#include <math.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SPMV_X86_DISPATCH 1
+#include <immintrin.h>
+#else
+#define SPMV_X86_DISPATCH 0
+#endif
+
+// ============ Détection du jeu d'instructions ============
+
+t_spmv_isa spmvBestIsa() {
+#if SPMV_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return SPMV_AVX2;
+    }
+#endif
+    return SPMV_SCALAR;
+}
+
+const char *spmvIsaName(t_spmv_isa isa) {
+    return isa == SPMV_AVX2 ? "avx2" : "scalaire";
+}
+
+// ============ Variante pull (transposée) ============
+
+typedef struct {
+    t_csr_matrix matrix;
+    const double *x;
+    double *y;
+    t_spmv_isa isa;
+    int rows_per_chunk;
+} t_spmv_pull_job;
+
+static void pullRowsScalar(t_csr_matrix matrix, const double *x, double *y,
+                           int row_start, int row_end) {
+    for (int i = row_start; i < row_end; i++) {
+        double sum = 0.0;
+        for (int k = matrix.row_ptr[i]; k < matrix.row_ptr[i + 1]; k++) {
+            sum += matrix.values[k] * x[matrix.col_idx[k]];
+        }
+        y[i] = sum;
+    }
+}
+
+#if SPMV_X86_DISPATCH
+// Quatre coefficients par itération : les indices de colonne servent directement
+// de vecteur d'indices pour le chargement indexé de x
+__attribute__((target("avx2,fma")))
+static void pullRowsAvx2(t_csr_matrix matrix, const double *x, double *y,
+                         int row_start, int row_end) {
+    for (int i = row_start; i < row_end; i++) {
+        int k = matrix.row_ptr[i];
+        int end = matrix.row_ptr[i + 1];
+        __m256d sum = _mm256_setzero_pd();
+        for (; k + 4 <= end; k += 4) {
+            __m128i columns = _mm_loadu_si128((const __m128i *)&matrix.col_idx[k]);
+            __m256d x_values = _mm256_i32gather_pd(x, columns, 8);
+            __m256d coefficients = _mm256_cvtps_pd(_mm_loadu_ps(&matrix.values[k]));
+            sum = _mm256_fmadd_pd(coefficients, x_values, sum);
+        }
+        __m128d half = _mm_add_pd(_mm256_castpd256_pd128(sum), _mm256_extractf128_pd(sum, 1));
+        double total = _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+        for (; k < end; k++) {
+            total += matrix.values[k] * x[matrix.col_idx[k]];
+        }
+        y[i] = total;
+    }
+}
+#endif
+
+static void pullTask(int task_index, void *context) {
+    t_spmv_pull_job *job = (t_spmv_pull_job *)context;
+    int row_start = task_index * job->rows_per_chunk;
+    int row_end = min(row_start + job->rows_per_chunk, job->matrix.rows);
+
+#if SPMV_X86_DISPATCH
+    if (job->isa == SPMV_AVX2) {
+        pullRowsAvx2(job->matrix, job->x, job->y, row_start, row_end);
+        return;
+    }
+#endif
+    pullRowsScalar(job->matrix, job->x, job->y, row_start, row_end);
+}
+
+void spmvPullIsa(t_csr_matrix transposed, const double *x, double *y, t_spmv_isa isa) {
+    t_spmv_pull_job job;
+    job.matrix = transposed;
+    job.x = x;
+    job.y = y;
+    job.isa = isa;
+
+    // Un produit trop petit ne rentabilise pas le lancement des threads
+    int nb_chunks = 1;
+    if (transposed.nnz >= SPMM_PARALLEL_MIN_WORK) {
+        nb_chunks = getThreadCount() * 4;
+    }
+    job.rows_per_chunk = (transposed.rows + nb_chunks - 1) / nb_chunks;
+    if (job.rows_per_chunk < 64) job.rows_per_chunk = 64;
+    nb_chunks = (transposed.rows + job.rows_per_chunk - 1) / job.rows_per_chunk;
+
+    parallelFor(nb_chunks, pullTask, &job);
+}
+
+void spmvPull(t_csr_matrix transposed, const double *x, double *y) {
+    static t_spmv_isa best_isa = SPMV_SCALAR;
+    static int detected = 0;
+    if (!detected) {
+        best_isa = spmvBestIsa();
+        detected = 1;
+    }
+    spmvPullIsa(transposed, x, y, best_isa);
+}
+
+// ============ Variante push (dispersion) ============
+
+// Pas de dispersion indexée en AVX2 : la boucle interne reste scalaire
+
+t_spmv_workspace createSpmvWorkspace(int n) {
+    t_spmv_workspace workspace;
+    workspace.n = n;
+    workspace.nb_parts = getThreadCount();
+    workspace.accumulators = NULL;
+    if (workspace.nb_parts > 1) {
+        size_t size = (size_t)workspace.nb_parts * n;
+        workspace.accumulators = (double *)malloc((size > 0 ? size : 1) * sizeof(double));
+        if (workspace.accumulators == NULL) {
+            perror("Failed to allocate memory for SpMV accumulators");
+            exit(EXIT_FAILURE);
+        }
+    }
+    return workspace;
+}
+
+void freeSpmvWorkspace(t_spmv_workspace *workspace) {
+    free(workspace->accumulators);
+    workspace->accumulators = NULL;
+}
+
+typedef struct {
+    t_csr_matrix matrix;
+    const double *x;
+    double *y;
+    t_spmv_workspace *workspace;
+    int rows_per_part;
+    int columns_per_part;
+} t_spmv_push_job;
+
+static void scatterRows(t_csr_matrix matrix, const double *x, double *accumulator,
+                        int row_start, int row_end) {
+    for (int i = row_start; i < row_end; i++) {
+        double xi = x[i];
+        if (xi == 0.0) continue;
+        for (int k = matrix.row_ptr[i]; k < matrix.row_ptr[i + 1]; k++) {
+            accumulator[matrix.col_idx[k]] += xi * matrix.values[k];
+        }
+    }
+}
+
+static void pushTask(int task_index, void *context) {
+    t_spmv_push_job *job = (t_spmv_push_job *)context;
+    int row_start = task_index * job->rows_per_part;
+    int row_end = min(row_start + job->rows_per_part, job->matrix.rows);
+    double *accumulator = &job->workspace->accumulators[(size_t)task_index * job->matrix.cols];
+
+    memset(accumulator, 0, job->matrix.cols * sizeof(double));
+    scatterRows(job->matrix, job->x, accumulator, row_start, row_end);
+}
+
+// Somme des accumulateurs, chaque thread se chargeant d'une tranche de colonnes
+static void reduceTask(int task_index, void *context) {
+    t_spmv_push_job *job = (t_spmv_push_job *)context;
+    int column_start = task_index * job->columns_per_part;
+    int column_end = min(column_start + job->columns_per_part, job->matrix.cols);
+    int n = job->matrix.cols;
+
+    for (int j = column_start; j < column_end; j++) {
+        double sum = 0.0;
+        for (int p = 0; p < job->workspace->nb_parts; p++) {
+            sum += job->workspace->accumulators[(size_t)p * n + j];
+        }
+        job->y[j] = sum;
+    }
+}
+
+void spmvPush(t_csr_matrix matrix, const double *x, double *y, t_spmv_workspace *workspace) {
+    if (workspace->n != matrix.cols) {
+        fprintf(stderr, "Error: SpMV workspace size does not match the matrix\n");
+        exit(EXIT_FAILURE);
+    }
+
+    if (workspace->nb_parts <= 1 || matrix.nnz < SPMM_PARALLEL_MIN_WORK) {
+        memset(y, 0, matrix.cols * sizeof(double));
+        scatterRows(matrix, x, y, 0, matrix.rows);
+        return;
+    }
+
+    t_spmv_push_job job;
+    job.matrix = matrix;
+    job.x = x;
+    job.y = y;
+    job.workspace = workspace;
+    job.rows_per_part = (matrix.rows + workspace->nb_parts - 1) / workspace->nb_parts;
+    job.columns_per_part = (matrix.cols + workspace->nb_parts - 1) / workspace->nb_parts;
+
+    parallelFor(workspace->nb_parts, pushTask, &job);
+    parallelFor(workspace->nb_parts, reduceTask, &job);
+}
+
+// ============ Banc d'essai ============
+
+typedef struct {
+    double *a;
+    const double *b;
+    const double *c;
+    size_t elements_per_chunk;
+    size_t nb_elements;
+} t_triad_job;
+
+static void triadTask(int task_index, void *context) {
+    t_triad_job *job = (t_triad_job *)context;
+    size_t start = (size_t)task_index * job->elements_per_chunk;
+    size_t end = start + job->elements_per_chunk;
+    if (end > job->nb_elements) end = job->nb_elements;
+    for (size_t i = start; i < end; i++) {
+        job->a[i] = job->b[i] + 3.0 * job->c[i];
+    }
+}
+
+// Bande passante soutenue a = b + s c (meilleure de quelques répétitions)
+static double measureBandwidth() {
+    size_t count = SPMV_BANDWIDTH_ELEMENTS;
+    double *a = (double *)malloc(count * sizeof(double));
+    double *b = (double *)malloc(count * sizeof(double));
+    double *c = (double *)malloc(count * sizeof(double));
+    if (a == NULL || b == NULL || c == NULL) {
+        perror("Failed to allocate memory for bandwidth measurement");
+        exit(EXIT_FAILURE);
+    }
+    for (size_t i = 0; i < count; i++) {
+        a[i] = 0.0;
+        b[i] = 1.0;
+        c[i] = 2.0;
+    }
+
+    t_triad_job job;
+    job.a = a;
+    job.b = b;
+    job.c = c;
+    job.nb_elements = count;
+    int nb_chunks = getThreadCount();
+    job.elements_per_chunk = (count + nb_chunks - 1) / nb_chunks;
+
+    double best = 0.0;
+    for (int repeat = 0; repeat < 5; repeat++) {
+        double start = getWallTime();
+        parallelFor(nb_chunks, triadTask, &job);
+        double seconds = getWallTime() - start;
+        double bandwidth = 3.0 * count * sizeof(double) / seconds / 1e9;
+        if (bandwidth > best) best = bandwidth;
+    }
+
+    free(a);
+    free(b);
+    free(c);
+    return best;
+}
+
+static double maxAbsDifference(const double *a, const double *b, int n) {
+    double worst = 0.0;
+    for (int i = 0; i < n; i++) {
+        double difference = fabs(a[i] - b[i]);
+        if (difference > worst) worst = difference;
+    }
+    return worst;
+}
+
+// Trafic minimal d'un produit : la matrice (indices et coefficients) et les
+// pointeurs de lignes sont lus une fois, x lu et y écrit une fois
+static void reportVariant(const char *name, double seconds, int iterations, t_csr_matrix matrix,
+                          double bandwidth, double difference) {
+    double per_product = seconds / iterations;
+    double bytes = (double)matrix.nnz * (sizeof(int) + sizeof(float))
+                 + (double)(matrix.rows + 1) * sizeof(int)
+                 + (double)(matrix.rows + matrix.cols) * sizeof(double);
+    double flops = 2.0 * matrix.nnz;
+    double achieved = bytes / per_product / 1e9;
+    double roofline = flops / bytes * bandwidth;
+
+    printf("%-16s %10.3f %9.2f %9.3f %9.3f %6.1f %%   %.1e\n", name, per_product * 1e3, achieved,
+           flops / per_product / 1e9, roofline, 100.0 * achieved / bandwidth, difference);
+}
+
+void runSpmvBenchmark(t_adjacency_list adj_list, int iterations) {
+    int n = adj_list.nb_vertices;
+    if (iterations < 1) iterations = 1;
+
+    double start = getWallTime();
+    t_csr_matrix matrix = adjacencyListToCSR(adj_list);
+    t_csr_matrix transposed = adjacencyListToTransposedCSR(adj_list);
+    double build_seconds = getWallTime() - start;
+
+    double bandwidth = measureBandwidth();
+    t_spmv_isa best_isa = spmvBestIsa();
+
+    printf("\n=== Banc d'essai SpMV y = x P (%d états, %d coefficients, %d threads) ===\n",
+           n, matrix.nnz, getThreadCount());
+    printf("Construction CSR + transposée: %.3f s\n", build_seconds);
+    printf("Jeu d'instructions détecté: %s\n", spmvIsaName(best_isa));
+    printf("Bande passante mémoire (triade): %.2f GB/s\n\n", bandwidth);
+
+    double *x = (double *)malloc((n > 0 ? n : 1) * sizeof(double));
+    double *reference = (double *)malloc((n > 0 ? n : 1) * sizeof(double));
+    double *y = (double *)malloc((n > 0 ? n : 1) * sizeof(double));
+    if (x == NULL || reference == NULL || y == NULL) {
+        perror("Failed to allocate memory for SpMV benchmark");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < n; i++) {
+        x[i] = 1.0 / n;
+    }
+    csrVectorMultiply(matrix, x, reference);
+
+    printf("Variante         ms/produit      GB/s   GFLOP/s  toit GF/s  %% bande   écart\n");
+
+    // Chaque variante : un produit de mise en température, puis la mesure
+    spmvPullIsa(transposed, x, y, SPMV_SCALAR);
+    start = getWallTime();
+    for (int it = 0; it < iterations; it++) {
+        spmvPullIsa(transposed, x, y, SPMV_SCALAR);
+    }
+    reportVariant("pull scalaire", getWallTime() - start, iterations, transposed, bandwidth,
+                  maxAbsDifference(y, reference, n));
+
+    if (best_isa == SPMV_AVX2) {
+        spmvPullIsa(transposed, x, y, SPMV_AVX2);
+        start = getWallTime();
+        for (int it = 0; it < iterations; it++) {
+            spmvPullIsa(transposed, x, y, SPMV_AVX2);
+        }
+        reportVariant("pull avx2", getWallTime() - start, iterations, transposed, bandwidth,
+                      maxAbsDifference(y, reference, n));
+    }
+
+    t_spmv_workspace workspace = createSpmvWorkspace(n);
+    spmvPush(matrix, x, y, &workspace);
+    start = getWallTime();
+    for (int it = 0; it < iterations; it++) {
+        spmvPush(matrix, x, y, &workspace);
+    }
+    reportVariant("push", getWallTime() - start, iterations, matrix, bandwidth,
+                  maxAbsDifference(y, reference, n));
+    freeSpmvWorkspace(&workspace);
+
+    printf("\nToit: intensité arithmétique x bande passante ; écart: max |y - x P|\n");
+    printf("=====================================================================\n\n");
+
+    free(x);
+    free(reference);
+    free(y);
+    freeCSRMatrix(&matrix);
+    freeCSRMatrix(&transposed);
+}
@@ -0,0 +1,44 @@
+#ifndef SPMV_H
+#define SPMV_H
+
+#include "sparse.h"
+
+// Nombre de doubles par tableau de la triade mesurant la bande passante (3 x 64 Mo)
+#define SPMV_BANDWIDTH_ELEMENTS (8 * 1024 * 1024)
+
+// Nombre de produits par défaut du banc d'essai
+#define SPMV_BENCH_DEFAULT_ITERATIONS 20
+
+// Jeu d'instructions des boucles internes
+typedef enum {
+    SPMV_SCALAR,           // Boucles C portables
+    SPMV_AVX2              // Chargements indexés AVX2 (gather) + FMA
+} t_spmv_isa;
+
+// Accumulateurs par thread de la variante push (alloués une fois, réutilisés)
+typedef struct {
+    double *accumulators;  // nb_parts vecteurs de n valeurs
+    int nb_parts;          // Nombre de paquets de lignes (un par thread)
+    int n;                 // Taille des vecteurs
+} t_spmv_workspace;
+
+// Meilleur jeu d'instructions disponible sur le processeur (détecté à l'exécution)
+t_spmv_isa spmvBestIsa();
+const char *spmvIsaName(t_spmv_isa isa);
+
+// Pull : y = x P en parcourant les lignes de la transposée P^T (chaque y[j] est
+// un produit scalaire indépendant, sans écriture concurrente)
+void spmvPull(t_csr_matrix transposed, const double *x, double *y);
+void spmvPullIsa(t_csr_matrix transposed, const double *x, double *y, t_spmv_isa isa);
+
+// Push : y = x P en dispersant chaque x[i] sur les successeurs de i, directement
+// sur la structure de P ; chaque thread accumule dans son propre vecteur
+t_spmv_workspace createSpmvWorkspace(int n);
+void freeSpmvWorkspace(t_spmv_workspace *workspace);
+void spmvPush(t_csr_matrix matrix, const double *x, double *y, t_spmv_workspace *workspace);
+
+// Banc d'essai : débit de chaque variante comparé au toit de bande passante
+// mesuré par une triade (le produit creux est limité par la mémoire)
+void runSpmvBenchmark(t_adjacency_list adj_list, int iterations);
+
+#endif // SPMV_H
@@ -240,4 +240,92 @@ int *createVertexToClassMap(t_partition partition, int nb_vertices) {
     }
 
     return map;
-}
\ No newline at end of file
+}
+
+// Créer un tableau qui associe chaque sommet à sa position dans sa classe
+int *createVertexToLocalIndexMap(t_partition partition, int nb_vertices) {
+    int *map = (int *)malloc(nb_vertices * sizeof(int));
+    if (map == NULL) {
+        perror("Failed to allocate memory for vertex to local index map");
+        exit(EXIT_FAILURE);
+    }
+
+    for (int i = 0; i < partition.nb_classes; i++) {
+        for (int j = 0; j < partition.classes[i].nb_vertices; j++) {
+            int vertex = partition.classes[i].vertices[j];
+            map[vertex - 1] = j;  // Position j dans la classe
+        }
+    }
+
+    return map;
+}
+
+// Taille et indice d'une classe, clés du tri par taille
+typedef struct {
+    int size;
+    int index;
+} t_class_size;
+
+// Taille décroissante, puis indice croissant (ordre total : le tri est déterministe)
+static int compareClassSizes(const void *a, const void *b) {
+    const t_class_size *ca = (const t_class_size *)a;
+    const t_class_size *cb = (const t_class_size *)b;
+    if (ca->size != cb->size) {
+        return (ca->size < cb->size) - (ca->size > cb->size);
+    }
+    return (ca->index > cb->index) - (ca->index < cb->index);
+}
+
+// Créer la liste des indices de classes triés par taille décroissante
+// (à taille égale, l'ordre de la partition est conservé)
+int *createClassOrderBySize(t_partition partition) {
+    int nb = partition.nb_classes;
+    int *order = (int *)malloc((nb > 0 ? nb : 1) * sizeof(int));
+    t_class_size *sizes = (t_class_size *)malloc((nb > 0 ? nb : 1) * sizeof(t_class_size));
+    if (order == NULL || sizes == NULL) {
+        perror("Failed to allocate memory for class order");
+        exit(EXIT_FAILURE);
+    }
+
+    // Tri en O(k log k) : une chaîne peut compter autant de classes que d'états
+    for (int i = 0; i < nb; i++) {
+        sizes[i].size = partition.classes[i].nb_vertices;
+        sizes[i].index = i;
+    }
+    qsort(sizes, nb, sizeof(t_class_size), compareClassSizes);
+    for (int i = 0; i < nb; i++) {
+        order[i] = sizes[i].index;
+    }
+
+    free(sizes);
+    return order;
+}
+
+// ============ Accessibilité arrière ============
+
+// Parcours en largeur sur l'index inverse du graphe
+int collectVerticesReaching(t_adjacency_list adj_list, const int *sources, int nb_sources,
+                            int *mark, int stamp, int *reached) {
+    const t_reverse_index *index = getReverseIndex(adj_list);
+
+    int head = 0, tail = 0;
+    for (int k = 0; k < nb_sources; k++) {
+        int v = sources[k] - 1;
+        if (mark[v] != stamp) {
+            mark[v] = stamp;
+            reached[tail++] = v;
+        }
+    }
+    while (head < tail) {
+        int v = reached[head++];
+        for (int e = index->offsets[v]; e < index->offsets[v + 1]; e++) {
+            int u = index->sources[e];
+            if (mark[u] != stamp && index->probabilities[e] > 0.0f) {
+                mark[u] = stamp;
+                reached[tail++] = u;
+            }
+        }
+    }
+
+    return tail;
+}
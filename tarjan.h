@@ -64,4 +64,18 @@ t_partition tarjan(t_adjacency_list adj_list);
 // Fonction pour créer un tableau associant chaque sommet à sa classe
 int *createVertexToClassMap(t_partition partition, int nb_vertices);
 
+// Fonction pour créer un tableau associant chaque sommet à sa position dans sa classe
+int *createVertexToLocalIndexMap(t_partition partition, int nb_vertices);
+
+// Fonction pour créer la liste des indices de classes, des plus grandes aux plus petites
+int *createClassOrderBySize(t_partition partition);
+
+// Sommets depuis lesquels l'un des sommets sources (1-indexés) est accessible,
+// sources comprises : parcours arrière sur l'index inverse du graphe. Chaque
+// sommet atteint reçoit mark[v] = stamp et est rangé (0-indexé) dans reached,
+// de taille nb_vertices ; la fonction renvoie leur nombre. Un tampon différent
+// à chaque appel permet d'enchaîner les parcours sans réinitialiser mark.
+int collectVerticesReaching(t_adjacency_list adj_list, const int *sources, int nb_sources,
+                            int *mark, int stamp, int *reached);
+
 #endif // TARJAN_H
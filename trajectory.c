@@ -0,0 +1,253 @@
+#include "trajectory.h"
+#include <stdlib.h>
+#include <string.h>
+
+// ============ Encodage ============
+
+static void flushBuffer(t_trajectory_writer *writer) {
+    if (writer->buffer_used == 0) return;
+    if (fwrite(writer->buffer, 1, writer->buffer_used, writer->file) != writer->buffer_used) {
+        perror("Failed to write trajectory file");
+        exit(EXIT_FAILURE);
+    }
+    writer->bytes_written += writer->buffer_used;
+    writer->buffer_used = 0;
+}
+
+// Garantir qu'au moins nb_bytes octets sont libres dans le tampon
+static void reserveBuffer(t_trajectory_writer *writer, size_t nb_bytes) {
+    if (writer->buffer_used + nb_bytes > TRAJECTORY_BUFFER_BYTES) {
+        flushBuffer(writer);
+    }
+}
+
+static void putVarint(t_trajectory_writer *writer, uint64_t value) {
+    unsigned char *out = writer->buffer + writer->buffer_used;
+    while (value >= 0x80) {
+        *out++ = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = (unsigned char)value;
+    writer->buffer_used = (size_t)(out - writer->buffer);
+}
+
+static void putFixed(t_trajectory_writer *writer, uint64_t value, int nb_bytes) {
+    for (int i = 0; i < nb_bytes; i++) {
+        writer->buffer[writer->buffer_used++] = (unsigned char)(value >> (8 * i));
+    }
+}
+
+// Zigzag : les petits écarts négatifs deviennent de petits entiers positifs
+static uint64_t zigzag(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static void encodeBlock(t_trajectory_writer *writer, const t_trajectory_block *block) {
+    // Pire cas : 3 varints d'en-tête + 10 octets par état
+    reserveBuffer(writer, 30 + (size_t)block->count * 10);
+
+    if (writer->nb_seeks == writer->seek_capacity) {
+        writer->seek_capacity *= 2;
+        writer->seeks = (t_trajectory_seek *)realloc(writer->seeks,
+                                                     writer->seek_capacity * sizeof(t_trajectory_seek));
+        if (writer->seeks == NULL) {
+            perror("Failed to allocate memory for trajectory index");
+            exit(EXIT_FAILURE);
+        }
+    }
+    t_trajectory_seek *seek = &writer->seeks[writer->nb_seeks++];
+    seek->walker = (uint64_t)block->walker;
+    seek->first_step = (uint64_t)block->first_step;
+    seek->offset = writer->bytes_written + writer->buffer_used;
+
+    putVarint(writer, (uint64_t)block->walker);
+    putVarint(writer, (uint64_t)block->first_step);
+    putVarint(writer, (uint64_t)block->count);
+    if (block->count == 0) return;
+
+    putVarint(writer, (uint64_t)block->states[0]);
+    for (int i = 1; i < block->count; i++) {
+        putVarint(writer, zigzag((int64_t)block->states[i] - block->states[i - 1]));
+    }
+}
+
+// ============ Thread écrivain ============
+
+static int hasPendingBlock(t_trajectory_writer *writer) {
+    for (int p = 0; p < writer->nb_producers; p++) {
+        t_trajectory_ring *ring = &writer->rings[p];
+        if (atomic_load(&ring->tail) < atomic_load(&ring->head)) return 1;
+    }
+    return 0;
+}
+
+static void *trajectoryWriterThread(void *arg) {
+    t_trajectory_writer *writer = (t_trajectory_writer *)arg;
+
+    while (1) {
+        // Vider tous les anneaux (les producteurs ne sont jamais bloqués par l'encodage)
+        int consumed = 0;
+        for (int p = 0; p < writer->nb_producers; p++) {
+            t_trajectory_ring *ring = &writer->rings[p];
+            long long tail = atomic_load(&ring->tail);
+            long long head = atomic_load(&ring->head);
+            for (; tail < head; tail++) {
+                encodeBlock(writer, &ring->blocks[tail % TRAJECTORY_RING_BLOCKS]);
+                atomic_store(&ring->tail, tail + 1);
+                consumed = 1;
+            }
+        }
+
+        pthread_mutex_lock(&writer->lock);
+        if (consumed) {
+            pthread_cond_broadcast(&writer->space_ready);
+        }
+        if (!hasPendingBlock(writer)) {
+            if (writer->done) {
+                pthread_mutex_unlock(&writer->lock);
+                break;
+            }
+            // Rien à encoder : écrire le tampon pendant que les producteurs travaillent
+            pthread_mutex_unlock(&writer->lock);
+            flushBuffer(writer);
+            pthread_mutex_lock(&writer->lock);
+            while (!hasPendingBlock(writer) && !writer->done) {
+                pthread_cond_wait(&writer->data_ready, &writer->lock);
+            }
+        }
+        pthread_mutex_unlock(&writer->lock);
+    }
+
+    flushBuffer(writer);
+    return NULL;
+}
+
+// ============ Interface des producteurs ============
+
+t_trajectory_writer *openTrajectoryWriter(const char *filename, int nb_producers, int nb_vertices,
+                                          long long walkers, long long steps, uint64_t seed) {
+    t_trajectory_writer *writer = (t_trajectory_writer *)calloc(1, sizeof(t_trajectory_writer));
+    if (writer == NULL) {
+        perror("Failed to allocate memory for trajectory writer");
+        exit(EXIT_FAILURE);
+    }
+
+    writer->file = fopen(filename, "wb");
+    if (writer->file == NULL) {
+        perror("Failed to open trajectory file");
+        exit(EXIT_FAILURE);
+    }
+
+    writer->nb_producers = nb_producers;
+    writer->rings = (t_trajectory_ring *)calloc(nb_producers, sizeof(t_trajectory_ring));
+    writer->buffer = (unsigned char *)malloc(TRAJECTORY_BUFFER_BYTES);
+    writer->seek_capacity = 1024;
+    writer->seeks = (t_trajectory_seek *)malloc(writer->seek_capacity * sizeof(t_trajectory_seek));
+    if (writer->rings == NULL || writer->buffer == NULL || writer->seeks == NULL) {
+        perror("Failed to allocate memory for trajectory writer");
+        exit(EXIT_FAILURE);
+    }
+    for (int p = 0; p < nb_producers; p++) {
+        writer->rings[p].blocks = (t_trajectory_block *)malloc(TRAJECTORY_RING_BLOCKS *
+                                                               sizeof(t_trajectory_block));
+        if (writer->rings[p].blocks == NULL) {
+            perror("Failed to allocate memory for trajectory ring");
+            exit(EXIT_FAILURE);
+        }
+        atomic_init(&writer->rings[p].head, 0);
+        atomic_init(&writer->rings[p].tail, 0);
+    }
+
+    pthread_mutex_init(&writer->lock, NULL);
+    pthread_cond_init(&writer->data_ready, NULL);
+    pthread_cond_init(&writer->space_ready, NULL);
+
+    // En-tête
+    memcpy(writer->buffer, TRAJECTORY_MAGIC, 4);
+    writer->buffer_used = 4;
+    putFixed(writer, TRAJECTORY_VERSION, 4);
+    putFixed(writer, (uint64_t)nb_vertices, 4);
+    putFixed(writer, (uint64_t)walkers, 8);
+    putFixed(writer, (uint64_t)steps, 8);
+    putFixed(writer, seed, 8);
+    putFixed(writer, TRAJECTORY_BLOCK_STEPS, 4);
+
+    if (pthread_create(&writer->thread, NULL, trajectoryWriterThread, writer) != 0) {
+        perror("Failed to start trajectory writer thread");
+        exit(EXIT_FAILURE);
+    }
+
+    return writer;
+}
+
+t_trajectory_block *reserveTrajectoryBlock(t_trajectory_writer *writer, int producer) {
+    t_trajectory_ring *ring = &writer->rings[producer];
+    long long slot = atomic_load(&ring->head) + ring->reserved;
+
+    // Anneau plein : attendre que l'écrivain libère un bloc
+    if (slot - atomic_load(&ring->tail) >= TRAJECTORY_RING_BLOCKS) {
+        ring->waits++;
+        pthread_mutex_lock(&writer->lock);
+        while (slot - atomic_load(&ring->tail) >= TRAJECTORY_RING_BLOCKS) {
+            pthread_cond_wait(&writer->space_ready, &writer->lock);
+        }
+        pthread_mutex_unlock(&writer->lock);
+    }
+
+    ring->reserved++;
+    return &ring->blocks[slot % TRAJECTORY_RING_BLOCKS];
+}
+
+void publishTrajectoryBlocks(t_trajectory_writer *writer, int producer) {
+    t_trajectory_ring *ring = &writer->rings[producer];
+    if (ring->reserved == 0) return;
+
+    atomic_fetch_add(&ring->head, ring->reserved);
+    ring->reserved = 0;
+
+    pthread_mutex_lock(&writer->lock);
+    pthread_cond_signal(&writer->data_ready);
+    pthread_mutex_unlock(&writer->lock);
+}
+
+uint64_t closeTrajectoryWriter(t_trajectory_writer *writer, long long *waits) {
+    pthread_mutex_lock(&writer->lock);
+    writer->done = 1;
+    pthread_cond_signal(&writer->data_ready);
+    pthread_mutex_unlock(&writer->lock);
+    pthread_join(writer->thread, NULL);
+
+    // Index des points de reprise puis pied de fichier
+    uint64_t index_offset = writer->bytes_written + writer->buffer_used;
+    for (long long i = 0; i < writer->nb_seeks; i++) {
+        reserveBuffer(writer, 24);
+        putFixed(writer, writer->seeks[i].walker, 8);
+        putFixed(writer, writer->seeks[i].first_step, 8);
+        putFixed(writer, writer->seeks[i].offset, 8);
+    }
+    reserveBuffer(writer, 20);
+    putFixed(writer, index_offset, 8);
+    putFixed(writer, (uint64_t)writer->nb_seeks, 8);
+    memcpy(writer->buffer + writer->buffer_used, TRAJECTORY_INDEX_MAGIC, 4);
+    writer->buffer_used += 4;
+    flushBuffer(writer);
+
+    uint64_t total_bytes = writer->bytes_written;
+    long long total_waits = 0;
+    for (int p = 0; p < writer->nb_producers; p++) {
+        total_waits += writer->rings[p].waits;
+        free(writer->rings[p].blocks);
+    }
+    if (waits != NULL) *waits = total_waits;
+
+    fclose(writer->file);
+    pthread_mutex_destroy(&writer->lock);
+    pthread_cond_destroy(&writer->data_ready);
+    pthread_cond_destroy(&writer->space_ready);
+    free(writer->rings);
+    free(writer->buffer);
+    free(writer->seeks);
+    free(writer);
+
+    return total_bytes;
+}
@@ -0,0 +1,92 @@
+#ifndef TRAJECTORY_H
+#define TRAJECTORY_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+// Nombre de pas par bloc ; chaque bloc commence par un état absolu (point de reprise)
+#define TRAJECTORY_BLOCK_STEPS 4096
+
+// Nombre de blocs de chaque anneau producteur
+#define TRAJECTORY_RING_BLOCKS 32
+
+// Taille du tampon d'écriture du thread écrivain
+#define TRAJECTORY_BUFFER_BYTES (1 << 20)
+
+// Identifiants du format binaire
+#define TRAJECTORY_MAGIC "MKTR"
+#define TRAJECTORY_INDEX_MAGIC "MKTI"
+#define TRAJECTORY_VERSION 2
+
+// Format du fichier (entiers de taille fixe en petit-boutiste) :
+//   en-tête : "MKTR", version u32, nb_vertices u32, walkers u64, steps u64, seed u64,
+//             block_steps u32
+//   blocs   : walker, first_step, count (varints), premier état (varint),
+//             puis count-1 écarts d'état codés zigzag + varint
+//   index   : pour chaque bloc walker u64, first_step u64, offset u64
+//   fin     : offset de l'index u64, nombre de blocs u64, "MKTI"
+// La position p d'une trajectoire est l'état après p pas : la position 0 est
+// l'état de départ, et une marche de k pas occupe les positions 0..k.
+// Les blocs des différents marcheurs apparaissent dans l'ordre d'écriture ;
+// l'index permet de retrouver la trajectoire d'un marcheur à partir d'un pas donné.
+
+// Bloc de pas d'un marcheur, rempli par un thread de simulation
+typedef struct {
+    long long walker;      // Numéro du marcheur
+    long long first_step;  // Position du premier état du bloc (0 = état de départ)
+    int count;             // Nombre d'états remplis
+    int states[TRAJECTORY_BLOCK_STEPS]; // États visités (0-indexés)
+} t_trajectory_block;
+
+// Anneau à un producteur et un consommateur
+typedef struct {
+    t_trajectory_block *blocks; // TRAJECTORY_RING_BLOCKS blocs
+    atomic_llong head;     // Blocs publiés par le producteur
+    atomic_llong tail;     // Blocs consommés par l'écrivain
+    long long reserved;    // Blocs réservés mais pas encore publiés (producteur seul)
+    long long waits;       // Attentes du producteur sur un anneau plein
+} t_trajectory_ring;
+
+// Entrée de l'index des points de reprise
+typedef struct {
+    uint64_t walker;
+    uint64_t first_step;
+    uint64_t offset;       // Position du bloc dans le fichier
+} t_trajectory_seek;
+
+// Écrivain de trajectoires : les producteurs remplissent leurs anneaux,
+// un thread dédié les vide, encode les blocs et écrit le fichier
+typedef struct {
+    FILE *file;
+    t_trajectory_ring *rings;
+    int nb_producers;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t data_ready;  // Signalé quand un bloc est publié
+    pthread_cond_t space_ready; // Signalé quand des blocs sont libérés
+    int done;              // Plus aucun bloc ne sera publié
+    unsigned char *buffer; // Tampon d'encodage
+    size_t buffer_used;
+    uint64_t bytes_written; // Octets déjà écrits dans le fichier
+    t_trajectory_seek *seeks;
+    long long nb_seeks;
+    long long seek_capacity;
+} t_trajectory_writer;
+
+// Ouvrir un fichier de trajectoires et démarrer le thread écrivain
+t_trajectory_writer *openTrajectoryWriter(const char *filename, int nb_producers, int nb_vertices,
+                                          long long walkers, long long steps, uint64_t seed);
+
+// Réserver le prochain bloc libre de l'anneau du producteur (attend si l'anneau est plein)
+t_trajectory_block *reserveTrajectoryBlock(t_trajectory_writer *writer, int producer);
+
+// Publier tous les blocs réservés par le producteur
+void publishTrajectoryBlocks(t_trajectory_writer *writer, int producer);
+
+// Vider les anneaux, écrire l'index et fermer le fichier
+// Retourne la taille du fichier ; *waits reçoit le total des attentes des producteurs
+uint64_t closeTrajectoryWriter(t_trajectory_writer *writer, long long *waits);
+
+#endif // TRAJECTORY_H